@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace utec {
+namespace bench {
+
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Stats {
+    std::string name;
+    size_t repetitions = 0;
+    size_t iterations_per_repetition = 0;
+    // Percentiles de la media por llamada de cada repeticion (ver Runner)
+    double median_ns = 0;
+    double p99_ns = 0;
+    double mean_ns = 0;
+    double min_ns = 0;
+    double max_ns = 0;
+    double items_per_second = 0;
+    double bytes_per_second = 0;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+struct Options {
+    size_t warmup = 3;
+    // Con 100 o mas repeticiones el p99 deja de ser el maximo
+    size_t repetitions = 100;
+    double min_sample_seconds = 1e-4;
+    std::string filter;
+    std::string json_path;
+};
+
+// Cada repeticion mide un lote de llamadas de al menos min_sample_seconds y guarda su media.
+// Mediana y p99 (rango mas cercano) son percentiles de esas medias por repeticion, no de
+// llamadas individuales: un pico aislado dentro de un lote se diluye en la media. Solo
+// cuando una llamada ya dura min_sample_seconds el lote es de 1 y son tiempos por llamada.
+// Con menos de 100 repeticiones el p99 coincide con el maximo.
+class Runner {
+    std::string suite_;
+    Options options_;
+    std::vector<Stats> results_;
+    bool header_printed_ = false;
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        const size_t rank = static_cast<size_t>(std::ceil(p * double(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+    }
+
+    static std::string json_escape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    static std::string format_time(double ns) {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2);
+        if (ns >= 1e9) os << ns / 1e9 << " s";
+        else if (ns >= 1e6) os << ns / 1e6 << " ms";
+        else if (ns >= 1e3) os << ns / 1e3 << " us";
+        else os << ns << " ns";
+        return os.str();
+    }
+
+    void print_header() {
+        if (header_printed_) return;
+        header_printed_ = true;
+        std::cout << std::left << std::setw(44) << "benchmark" << std::right
+                  << std::setw(14) << "mediana" << std::setw(14) << "p99"
+                  << std::setw(8) << "reps" << std::setw(18) << "throughput" << '\n';
+        std::cout << std::string(98, '-') << '\n';
+    }
+
+    void print(const Stats& stats) {
+        print_header();
+        std::ostringstream throughput;
+        throughput << std::fixed << std::setprecision(2);
+        if (stats.bytes_per_second > 0) throughput << stats.bytes_per_second / 1e9 << " GB/s";
+        else if (stats.items_per_second >= 1e6) throughput << stats.items_per_second / 1e6 << " M/s";
+        else if (stats.items_per_second > 0) throughput << stats.items_per_second / 1e3 << " K/s";
+        std::cout << std::left << std::setw(44) << stats.name << std::right
+                  << std::setw(14) << format_time(stats.median_ns)
+                  << std::setw(14) << format_time(stats.p99_ns)
+                  << std::setw(8) << stats.repetitions
+                  << std::setw(18) << throughput.str() << '\n';
+    }
+
+public:
+    Runner(std::string suite, int argc, char** argv, Options defaults = Options())
+            : suite_(std::move(suite)), options_(std::move(defaults)) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+            if (arg.rfind("--json=", 0) == 0) options_.json_path = value("--json=");
+            else if (arg.rfind("--filter=", 0) == 0) options_.filter = value("--filter=");
+            else if (arg.rfind("--reps=", 0) == 0) options_.repetitions = std::max<size_t>(1, std::stoul(value("--reps=")));
+            else if (arg.rfind("--warmup=", 0) == 0) options_.warmup = std::stoul(value("--warmup="));
+            else if (arg.rfind("--min-time=", 0) == 0) options_.min_sample_seconds = std::stod(value("--min-time="));
+            else {
+                std::cerr << "Uso: " << argv[0]
+                          << " [--json=archivo] [--filter=texto] [--reps=N] [--warmup=N] [--min-time=segundos]\n";
+                std::exit(1);
+            }
+        }
+    }
+
+    const Options& options() const { return options_; }
+    const std::vector<Stats>& results() const { return results_; }
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    // items / bytes son por llamada a fn; se usan para calcular el throughput
+    template<typename F>
+    std::optional<Stats> run(const std::string& name, F&& fn, double items = 0, double bytes = 0) {
+        if (!selected(name)) return std::nullopt;
+        using clock = std::chrono::steady_clock;
+
+        for (size_t i = 0; i < options_.warmup; ++i) fn();
+
+        auto start = clock::now();
+        fn();
+        const double single = std::chrono::duration<double>(clock::now() - start).count();
+        size_t batch = 1;
+        if (single > 0 && single < options_.min_sample_seconds) {
+            batch = static_cast<size_t>(std::ceil(options_.min_sample_seconds / single));
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options_.repetitions);
+        for (size_t rep = 0; rep < options_.repetitions; ++rep) {
+            start = clock::now();
+            for (size_t i = 0; i < batch; ++i) fn();
+            const double elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            samples.push_back(elapsed / double(batch));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Stats stats;
+        stats.name = name;
+        stats.repetitions = samples.size();
+        stats.iterations_per_repetition = batch;
+        stats.median_ns = samples.size() % 2 == 1
+                          ? samples[samples.size() / 2]
+                          : 0.5 * (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]);
+        stats.p99_ns = percentile(samples, 0.99);
+        stats.min_ns = samples.front();
+        stats.max_ns = samples.back();
+        double sum = 0;
+        for (double s : samples) sum += s;
+        stats.mean_ns = sum / double(samples.size());
+        if (items > 0) stats.items_per_second = items / (stats.median_ns * 1e-9);
+        if (bytes > 0) stats.bytes_per_second = bytes / (stats.median_ns * 1e-9);
+
+        print(stats);
+        results_.push_back(stats);
+        return stats;
+    }
+
+    void add_counter(const std::string& name, double value) {
+        if (!results_.empty()) results_.back().counters.emplace_back(name, value);
+    }
+
+    void write_json(std::ostream& os) const {
+        int threads = 1;
+#ifdef _OPENMP
+        threads = omp_get_max_threads();
+#endif
+        const std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        os << std::setprecision(6) << std::fixed;
+        os << "{\n  \"context\": {\n"
+           << "    \"suite\": \"" << json_escape(suite_) << "\",\n"
+           << "    \"date\": \"" << date << "\",\n"
+           << "    \"threads\": " << threads << ",\n"
+#if defined(__clang__)
+           << "    \"compiler\": \"clang " << __clang_version__ << "\",\n"
+#elif defined(__GNUC__)
+           << "    \"compiler\": \"gcc " << __VERSION__ << "\",\n"
+#else
+           << "    \"compiler\": \"unknown\",\n"
+#endif
+#ifdef NDEBUG
+           << "    \"assertions\": false,\n"
+#else
+           << "    \"assertions\": true,\n"
+#endif
+           << "    \"repetitions\": " << options_.repetitions << ",\n"
+           << "    \"percentiles_of\": \"per-repetition batch means\",\n"
+           << "    \"warmup\": " << options_.warmup << "\n  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            os << (i ? ",\n" : "\n") << "    {\"name\": \"" << json_escape(r.name) << "\""
+               << ", \"repetitions\": " << r.repetitions
+               << ", \"iterations\": " << r.iterations_per_repetition
+               << ", \"median_ns\": " << r.median_ns
+               << ", \"p99_ns\": " << r.p99_ns
+               << ", \"mean_ns\": " << r.mean_ns
+               << ", \"min_ns\": " << r.min_ns
+               << ", \"max_ns\": " << r.max_ns
+               << ", \"items_per_second\": " << r.items_per_second
+               << ", \"bytes_per_second\": " << r.bytes_per_second;
+            for (const auto& counter : r.counters)
+                os << ", \"" << json_escape(counter.first) << "\": " << counter.second;
+            os << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    // Escribe el JSON si se paso --json=; devuelve el codigo de salida para main
+    int finish() const {
+        if (options_.json_path.empty()) return 0;
+        std::ofstream file(options_.json_path);
+        if (!file) {
+            std::cerr << "No se pudo escribir " << options_.json_path << '\n';
+            return 1;
+        }
+        write_json(file);
+        std::cout << "\nResultados JSON: " << options_.json_path << '\n';
+        return 0;
+    }
+};
+
+}
+}
@@ -0,0 +1,179 @@
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "../include/tensor.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_activation.h"
+#include "../include/nn_loss.h"
+#include "../include/nn_optimizer.h"
+#include "../include/neural_network.h"
+#include "../include/nn_graph.h"
+#include "../include/nn_ensemble.h"
+#include "../include/nn_conv.h"
+#include "../include/nn_sweep.h"
+#include "../include/nn_online.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+using utec::bench::do_not_optimize;
+
+namespace {
+
+using T = double;
+
+// Mismo problema y arquitectura que src/main.cpp: XOR, 2 -> 64 -> 64 -> 1
+std::pair<Tensor<T, 2>, Tensor<T, 2>> xor_data(size_t samples) {
+    std::mt19937 gen(123);
+    std::uniform_real_distribution<T> dist(-0.1, 0.1);
+    Tensor<T, 2> X(samples, 2);
+    Tensor<T, 2> Y(samples, 1);
+    for (size_t i = 0; i < samples; ++i) {
+        T x1 = (i % 4 < 2) ? T(0) : T(1);
+        T x2 = (i % 2 == 0) ? T(0) : T(1);
+        X(i, 0) = x1 + dist(gen);
+        X(i, 1) = x2 + dist(gen);
+        Y(i, 0) = (x1 != x2) ? T(1) : T(0);
+    }
+    return {X, Y};
+}
+
+void build(NeuralNetwork<T>& network, size_t hidden) {
+    network.add_dense_layer(2, hidden);
+    network.add_relu_layer();
+    network.add_dense_layer(hidden, hidden);
+    network.add_relu_layer();
+    network.add_dense_layer(hidden, 1);
+    network.add_sigmoid_layer();
+}
+
+}
+
+int main(int argc, char** argv) {
+    utec::bench::Options options;
+    options.warmup = 1;
+    options.repetitions = 10;
+    utec::bench::Runner runner("macro", argc, argv, options);
+
+    const size_t samples = 4096;
+    auto [X, Y] = xor_data(samples);
+
+    for (size_t batch_size : {32, 128, 512}) {
+        NeuralNetwork<T> network;
+        build(network, 64);
+        runner.run("train/xor_2-64-64-1/batch" + std::to_string(batch_size) + "/epoch",
+                   [&] { network.train<BCELoss, SGD>(X, Y, 1, batch_size, T(0.01)); }, double(samples));
+    }
+
+    // Mismo entrenamiento con el grafo estatico: buffers planificados, sin reservas por paso
+    for (size_t batch_size : {32, 128, 512}) {
+        NeuralNetwork<T> network;
+        build(network, 64);
+        StaticGraph<T, BCELoss> graph(network, batch_size, 2);
+        SGD<T> optimizer(T(0.01));
+        runner.run("train_graph/xor_2-64-64-1/batch" + std::to_string(batch_size) + "/epoch",
+                   [&] { do_not_optimize(graph.train_epoch(X, Y, optimizer)); }, double(samples));
+        runner.add_counter("slab_bytes", double(graph.peak_bytes()));
+        runner.add_counter("unplanned_bytes", double(graph.unplanned_bytes()));
+    }
+
+    NeuralNetwork<T> network;
+    build(network, 64);
+    for (size_t rows : {1, 32, 1000}) {
+        Tensor<T, 2> batch(rows, 2);
+        std::copy(X.cbegin(), X.cbegin() + batch.size(), batch.begin());
+        runner.run("predict/xor_2-64-64-1/batch" + std::to_string(rows),
+                   [&] { do_not_optimize(network.predict(batch)); }, double(rows));
+    }
+
+    // Muchas redes chicas sobre el mismo batch: predict por red frente al ensemble apilado
+    const size_t models = 200, rows = 128;
+    std::vector<NeuralNetwork<T>> networks(models);
+    for (auto& member : networks) build(member, 64);
+    NetworkEnsemble<T> ensemble(networks);
+    Tensor<T, 2> request(rows, 2);
+    std::copy(X.cbegin(), X.cbegin() + request.size(), request.begin());
+    runner.run("ensemble/xor_2-64-64-1/models200/loop_predict", [&] {
+        for (auto& member : networks) do_not_optimize(member.predict(request));
+    }, double(models * rows));
+    runner.run("ensemble/xor_2-64-64-1/models200/batched",
+               [&] { do_not_optimize(ensemble.predict(request)); }, double(models * rows));
+
+    // CNN chica sobre imagenes 1x28x28: conv(8, 3x3) -> relu -> pool -> conv(16, 3x3) -> relu -> pool -> dense(10)
+    {
+        NeuralNetwork<T> cnn;
+        cnn.add_layer(std::make_unique<Conv2D<T>>(ImageShape{1, 28, 28}, 8, 3, 1, 1));
+        cnn.add_relu_layer();
+        cnn.add_layer(std::make_unique<MaxPool2D<T>>(ImageShape{8, 28, 28}, 2));
+        cnn.add_layer(std::make_unique<Conv2D<T>>(ImageShape{8, 14, 14}, 16, 3, 1, 1));
+        cnn.add_relu_layer();
+        cnn.add_layer(std::make_unique<MaxPool2D<T>>(ImageShape{16, 14, 14}, 2));
+        cnn.add_dense_layer(16 * 7 * 7, 10);
+        cnn.add_softmax_layer();
+
+        const size_t images = 64;
+        Tensor<T, 2> batch(images, 28 * 28), labels(images, 10);
+        fill_uniform(batch, T(0), T(1), RandomStream{3, 0});
+        labels.fill(T(0));
+        for (size_t i = 0; i < images; ++i) labels(i, i % 10) = T(1);
+        SGD<T> sgd(T(0.01));
+        runner.run("conv/lenet_1x28x28/batch64/predict", [&] { do_not_optimize(cnn.predict(batch)); },
+                   double(images));
+        runner.run("conv/lenet_1x28x28/batch64/train_step", [&] {
+            do_not_optimize(cnn.train_epoch<CrossEntropyLoss>(batch, labels, images, sgd));
+        }, double(images));
+    }
+
+    // Busqueda de 8 configuraciones con successive halving: un worker frente a uno por nucleo
+    {
+        auto [X, Y] = xor_data(2048);
+        auto [X_val, Y_val] = xor_data(512);
+        SweepSpace<T> space;
+        space.batch_sizes = {32, 128};
+        space.learning_rates = {T(0.003), T(0.03)};
+        space.hidden_widths = {16, 32};
+        const auto configs = space.grid();
+        const size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+        for (size_t workers : {size_t(1), cores}) {
+            SweepOptions options;
+            options.min_epochs = 1;
+            options.max_epochs = 4;
+            options.eta = 2;
+            options.workers = workers;
+            HyperparameterSweep<T> sweep([](NeuralNetwork<T>& network, const SweepConfig<T>& config) {
+                build(network, config.hidden);
+            }, options);
+            runner.run("sweep/xor_8configs/workers" + std::to_string(workers), [&] {
+                do_not_optimize(sweep.run(configs, X, Y, X_val, Y_val));
+            }, double(configs.size()));
+            if (cores == 1) break;
+        }
+    }
+
+    // Aprendizaje incremental: un paso de 32 filas (publicando cada 16) y predict de una fila
+    {
+        auto [X, Y] = xor_data(32);
+        Tensor<T, 2> request(1, 2);
+        request(0, 0) = T(1);
+        request(0, 1) = T(0);
+        NeuralNetwork<T> network;
+        build(network, 64);
+        OnlineLearner<T> learner(std::move(network), 2, T(0.01), OnlineOptions{32, 16, 4096});
+        // Percentiles de la ventana del propio learner; el clon de cada publicacion va aparte
+        if (runner.run("online/xor_2-64-64-1/partial_fit32", [&] { do_not_optimize(learner.partial_fit(X, Y)); },
+                       double(X.shape()[0]))) {
+            const auto latency = learner.update_latency();
+            runner.add_counter("p50_us", latency.p50_us);
+            runner.add_counter("p99_us", latency.p99_us);
+            runner.add_counter("publish_p50_us", learner.publish_latency().p50_us);
+        }
+        if (runner.run("online/xor_2-64-64-1/predict1", [&] { do_not_optimize(learner.predict(request)); }, 1.0)) {
+            const auto latency = learner.predict_latency();
+            runner.add_counter("p50_us", latency.p50_us);
+            runner.add_counter("p99_us", latency.p99_us);
+        }
+    }
+    return runner.finish();
+}
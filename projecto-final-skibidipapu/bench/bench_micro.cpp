@@ -0,0 +1,193 @@
+#include <random>
+#include <string>
+#include <utility>
+#include "bench_harness.h"
+#include "../include/tensor.h"
+#include "../include/tensor_random.h"
+#include "../include/nn_activation.h"
+#include "../include/nn_loss.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+using utec::bench::do_not_optimize;
+
+namespace {
+
+using T = double;
+
+Tensor<T, 2> random_tensor(size_t rows, size_t cols, unsigned seed, T lo = -1, T hi = 1) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dist(lo, hi);
+    Tensor<T, 2> tensor(rows, cols);
+    for (auto& value : tensor) value = dist(gen);
+    return tensor;
+}
+
+void bench_matmul(utec::bench::Runner& runner) {
+    for (size_t n : {32, 64, 128, 256}) {
+        auto A = random_tensor(n, n, 1);
+        auto B = random_tensor(n, n, 2);
+        runner.run("matmul/" + std::to_string(n) + "x" + std::to_string(n),
+                   [&] { do_not_optimize(A.matmul(B)); }, 2.0 * n * n * n);
+    }
+    auto X = random_tensor(128, 64, 3);
+    auto W = random_tensor(64, 64, 4);
+    runner.run("matmul/128x64*64x64", [&] { do_not_optimize(X.matmul(W)); }, 2.0 * 128 * 64 * 64);
+}
+
+// Copia elemento a elemento (la implementacion anterior de transpose_2d) como referencia
+Tensor<T, 2> naive_transpose(const Tensor<T, 2>& A) {
+    Tensor<T, 2> result(A.shape()[1], A.shape()[0]);
+    for (size_t i = 0; i < A.shape()[0]; ++i)
+        for (size_t j = 0; j < A.shape()[1]; ++j)
+            result(j, i) = A(i, j);
+    return result;
+}
+
+void bench_transpose(utec::bench::Runner& runner) {
+    const std::pair<size_t, size_t> shapes[] = {{64, 64}, {256, 256}, {1000, 1000}, {1024, 1024},
+                                                {4096, 64}, {64, 4096}};
+    for (auto [rows, cols] : shapes) {
+        auto A = random_tensor(rows, cols, 5);
+        const std::string shape = std::to_string(rows) + "x" + std::to_string(cols);
+        const double bytes = 2.0 * A.size() * sizeof(T);
+        runner.run("transpose/" + shape, [&] { do_not_optimize(A.transpose()); }, 0, bytes);
+        runner.run("transpose/" + shape + "/naive", [&] { do_not_optimize(naive_transpose(A)); }, 0, bytes);
+    }
+    auto square = random_tensor(1024, 1024, 6);
+    runner.run("transpose/1024x1024/in_place", [&] {
+        square.transpose_in_place();
+        do_not_optimize(square);
+    }, 0, 2.0 * square.size() * sizeof(T));
+
+    Tensor<T, 3> batched(16, 128, 256);
+    fill_uniform(batched, T(-1), T(1), RandomStream{7, 0});
+    runner.run("transpose/16x128x256", [&] { do_not_optimize(batched.transpose_2d()); }, 0,
+               2.0 * batched.size() * sizeof(T));
+}
+
+void bench_broadcasting(utec::bench::Runner& runner) {
+    const size_t rows = 256, cols = 256;
+    auto A = random_tensor(rows, cols, 7);
+    auto B = random_tensor(rows, cols, 8);
+    auto row = random_tensor(1, cols, 9);
+    const double bytes = 3.0 * rows * cols * sizeof(T);
+    const double unary_bytes = 2.0 * rows * cols * sizeof(T);
+    runner.run("elementwise/add_256x256",
+               [&] { Tensor<T, 2> r = A + B; do_not_optimize(r); }, rows * cols, bytes);
+    runner.run("elementwise/mul_256x256",
+               [&] { Tensor<T, 2> r = A * B; do_not_optimize(r); }, rows * cols, bytes);
+    runner.run("broadcast/add_256x256+1x256",
+               [&] { Tensor<T, 2> r = A + row; do_not_optimize(r); }, rows * cols, bytes);
+    runner.run("scalar/mul_256x256",
+               [&] { Tensor<T, 2> r = A * T(2); do_not_optimize(r); }, rows * cols, unary_bytes);
+    runner.run("scalar/chain_256x256",
+               [&] { Tensor<T, 2> r = A * T(2) + T(1); do_not_optimize(r); }, rows * cols, unary_bytes);
+    runner.run("scalar/chain_256x256/lazy",
+               [&] { Tensor<T, 2> r = lazy(A) * T(2) + T(1); do_not_optimize(r); }, rows * cols, unary_bytes);
+    runner.run("reduce/sum_rows_256x256", [&] { do_not_optimize(A.sum_rows()); }, rows * cols,
+               rows * cols * sizeof(T));
+    runner.run("reduce/sum_axis1_256x256", [&] { do_not_optimize(sum(A, 1)); }, rows * cols,
+               rows * cols * sizeof(T));
+    runner.run("reduce/amax_axis0_256x256", [&] { do_not_optimize(amax(A, 0)); }, rows * cols,
+               rows * cols * sizeof(T));
+    runner.run("reduce/argmax_axis1_256x256", [&] { do_not_optimize(argmax(A, 1)); }, rows * cols,
+               rows * cols * sizeof(T));
+    runner.run("reduce/logsumexp_axis1_256x256", [&] { do_not_optimize(logsumexp(A, 1)); }, rows * cols,
+               rows * cols * sizeof(T));
+}
+
+template<typename Layer>
+void bench_activation(utec::bench::Runner& runner, const std::string& name) {
+    const size_t rows = 128, cols = 256;
+    auto X = random_tensor(rows, cols, 10);
+    auto G = random_tensor(rows, cols, 11);
+    Layer layer;
+    const double bytes = 2.0 * rows * cols * sizeof(T);
+    runner.run("activation/" + name + "/forward", [&] { do_not_optimize(layer.forward(X)); }, rows * cols, bytes);
+    layer.forward(X);
+    runner.run("activation/" + name + "/backward", [&] { do_not_optimize(layer.backward(G)); }, rows * cols, bytes);
+}
+
+template<typename Loss>
+void bench_loss(utec::bench::Runner& runner, const std::string& name, size_t cols, bool one_hot) {
+    const size_t rows = 1024;
+    auto pred = random_tensor(rows, cols, 12, T(0.01), T(0.99));
+    auto target = random_tensor(rows, cols, 13, T(0), T(1));
+    if (one_hot) {
+        target.fill(T(0));
+        for (size_t i = 0; i < rows; ++i) target(i, i % cols) = T(1);
+    }
+    const double items = double(rows * cols);
+    runner.run("loss/" + name + "/loss", [&] { Loss loss(pred, target); do_not_optimize(loss.loss()); }, items);
+    runner.run("loss/" + name + "/gradient",
+               [&] { Loss loss(pred, target); do_not_optimize(loss.loss_gradient()); }, items);
+    // Una sola pasada sobre un buffer de gradiente reutilizado
+    Tensor<T, 2> grad(rows, cols);
+    runner.run("loss/" + name + "/compute",
+               [&] { Loss loss(pred, target); do_not_optimize(loss.compute(grad)); }, items);
+}
+
+// Softmax + CrossEntropy por separado frente a la perdida fusionada sobre logits
+void bench_softmax_cross_entropy(utec::bench::Runner& runner) {
+    const size_t rows = 1024, classes = 10;
+    auto logits = random_tensor(rows, classes, 14, T(-3), T(3));
+    Tensor<T, 2> one_hot(rows, classes), labels(rows, 1);
+    one_hot.fill(T(0));
+    for (size_t i = 0; i < rows; ++i) {
+        labels[i] = T(i % classes);
+        one_hot(i, i % classes) = T(1);
+    }
+    const double items = double(rows * classes);
+    Tensor<T, 2> grad(rows, classes);
+    runner.run("loss/softmax_cross_entropy/unfused", [&] {
+        Softmax<T> softmax;
+        const auto probabilities = softmax.forward(logits);
+        CrossEntropyLoss<T> loss(probabilities, one_hot);
+        do_not_optimize(loss.loss());
+        do_not_optimize(softmax.backward(loss.loss_gradient()));
+    }, items);
+    runner.run("loss/softmax_cross_entropy/fused_one_hot", [&] {
+        SoftmaxCrossEntropyLoss<T> loss(logits, one_hot);
+        do_not_optimize(loss.compute(grad));
+    }, items);
+    runner.run("loss/softmax_cross_entropy/fused_sparse", [&] {
+        SoftmaxCrossEntropyLoss<T> loss(logits, labels);
+        do_not_optimize(loss.compute(grad));
+    }, items);
+}
+
+// Philox por contador frente a mt19937 + normal_distribution secuencial
+void bench_random(utec::bench::Runner& runner) {
+    const size_t rows = 512, cols = 512;
+    Tensor<T, 2> tensor(rows, cols);
+    const double items = double(rows * cols), bytes = items * sizeof(T);
+    runner.run("random/mt19937_normal_512x512", [&] {
+        std::mt19937 gen(1);
+        std::normal_distribution<T> dist(T(0), T(1));
+        for (auto& value : tensor) value = dist(gen);
+        do_not_optimize(tensor);
+    }, items, bytes);
+    runner.run("random/philox_normal_512x512",
+               [&] { fill_normal(tensor, T(0), T(1), RandomStream{1, 0}); do_not_optimize(tensor); }, items, bytes);
+    runner.run("random/philox_uniform_512x512",
+               [&] { fill_uniform(tensor, T(-1), T(1), RandomStream{1, 0}); do_not_optimize(tensor); }, items, bytes);
+}
+
+}
+
+int main(int argc, char** argv) {
+    utec::bench::Runner runner("micro", argc, argv);
+    bench_matmul(runner);
+    bench_transpose(runner);
+    bench_broadcasting(runner);
+    bench_activation<ReLU<T>>(runner, "relu");
+    bench_activation<Sigmoid<T>>(runner, "sigmoid");
+    bench_activation<Softmax<T>>(runner, "softmax");
+    bench_loss<MSELoss<T>>(runner, "mse", 1, false);
+    bench_loss<BCELoss<T>>(runner, "bce", 1, false);
+    bench_loss<CrossEntropyLoss<T>>(runner, "cross_entropy", 10, true);
+    bench_softmax_cross_entropy(runner);
+    bench_random(runner);
+    return runner.finish();
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <string>
+#include "bench_harness.h"
+#include "../include/tensor.h"
+#include "../include/bfloat16.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_mixed_precision.h"
+#include "../include/nn_activation.h"
+#include "../include/nn_loss.h"
+#include "../include/nn_optimizer.h"
+#include "../include/neural_network.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+using utec::bench::do_not_optimize;
+
+namespace {
+
+constexpr size_t kFeatures = 64;
+constexpr size_t kHidden = 256;
+constexpr size_t kSamples = 2048;
+constexpr size_t kBatch = 256;
+
+template<typename T>
+std::pair<Tensor<T, 2>, Tensor<T, 2>> make_data() {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    Tensor<T, 2> X(kSamples, kFeatures);
+    Tensor<T, 2> Y(kSamples, 1);
+    for (size_t i = 0; i < kSamples; ++i) {
+        for (size_t j = 0; j < kFeatures; ++j)
+            X(i, j) = static_cast<T>(dist(gen));
+        Y(i, 0) = (X(i, 0) * X(i, 1) > T(0)) ? T(1) : T(0);
+    }
+    return {X, Y};
+}
+
+template<typename T, typename DenseLayer>
+void build(NeuralNetwork<T>& network) {
+    network.add_layer(std::make_unique<DenseLayer>(kFeatures, kHidden));
+    network.add_layer(std::make_unique<ReLU<T>>());
+    network.add_layer(std::make_unique<DenseLayer>(kHidden, kHidden));
+    network.add_layer(std::make_unique<ReLU<T>>());
+    network.add_layer(std::make_unique<DenseLayer>(kHidden, 1));
+    network.add_layer(std::make_unique<Sigmoid<T>>());
+}
+
+struct Result {
+    std::string name;
+    double train_samples_per_s;
+    double predict_samples_per_s;
+    size_t parameter_bytes;
+    size_t activation_bytes;
+};
+
+// Bytes de parametros y de activaciones cacheadas por las capas densas y ReLU en un batch
+size_t parameter_bytes(size_t param_size) {
+    const size_t params = kFeatures * kHidden + kHidden + kHidden * kHidden + kHidden + kHidden + 1;
+    return params * param_size;
+}
+
+size_t activation_bytes(size_t dense_cache_size, size_t activation_size) {
+    const size_t dense_inputs = kBatch * (kFeatures + kHidden + kHidden);
+    const size_t activation_inputs = kBatch * (kHidden + kHidden + 1);
+    return dense_inputs * dense_cache_size + activation_inputs * activation_size;
+}
+
+template<typename T, typename DenseLayer, template<typename...> class Optimizer = SGD>
+Result run(utec::bench::Runner& runner, const std::string& name, size_t param_size, size_t dense_cache_size) {
+    auto [X, Y] = make_data<T>();
+    NeuralNetwork<T> network;
+    build<T, DenseLayer>(network);
+
+    auto train = runner.run(name + "/train_epoch", [&] {
+        network.template train<BCELoss, Optimizer>(X, Y, 1, kBatch, T(0.01));
+    }, double(kSamples));
+    auto predict = runner.run(name + "/predict", [&] {
+        do_not_optimize(network.predict(X));
+    }, double(kSamples));
+
+    Result result{name, train ? train->items_per_second : 0.0, predict ? predict->items_per_second : 0.0,
+                  parameter_bytes(param_size), activation_bytes(dense_cache_size, sizeof(T))};
+    runner.add_counter("parameter_bytes", double(result.parameter_bytes));
+    runner.add_counter("activation_bytes", double(result.activation_bytes));
+    return result;
+}
+
+}
+
+int main(int argc, char** argv) {
+    utec::bench::Options options;
+    options.warmup = 1;
+    options.repetitions = 5;
+    utec::bench::Runner runner("mixed_precision", argc, argv, options);
+
+    std::vector<Result> results;
+    results.push_back(run<double, Dense<double>>(runner, "double_dense", sizeof(double), sizeof(double)));
+    results.push_back(run<float, Dense<float>>(runner, "float_dense", sizeof(float), sizeof(float)));
+    results.push_back(run<float, MixedDense<float>>(runner, "float_mixed", sizeof(float), sizeof(float)));
+    results.push_back(run<float, BF16Dense<float>>(runner, "bf16_float_acc", sizeof(bfloat16), sizeof(bfloat16)));
+    results.push_back(run<float, BF16Dense<float>, MasterSGD>(runner, "bf16_fp64_master",
+                                                               sizeof(bfloat16), sizeof(bfloat16)));
+
+    const Result& baseline = results.front();
+    std::cout << "\nArquitectura: " << kFeatures << " -> " << kHidden << " -> " << kHidden << " -> 1, batch "
+              << kBatch << ", " << kSamples << " muestras\n\n";
+    std::cout << std::left << std::setw(22) << "configuracion"
+              << std::right << std::setw(16) << "train (m/s)"
+              << std::setw(16) << "predict (m/s)"
+              << std::setw(12) << "params KB"
+              << std::setw(14) << "activ. KB"
+              << std::setw(10) << "speedup" << '\n';
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(22) << r.name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(16) << r.train_samples_per_s
+                  << std::setw(16) << r.predict_samples_per_s
+                  << std::setw(12) << r.parameter_bytes / 1024
+                  << std::setw(14) << r.activation_bytes / 1024
+                  << std::setprecision(2)
+                  << std::setw(10) << (baseline.train_samples_per_s > 0
+                                       ? r.train_samples_per_s / baseline.train_samples_per_s : 0.0) << '\n';
+    }
+    return runner.finish();
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include "bench_harness.h"
+#include "../include/tensor.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_activation.h"
+#include "../include/nn_loss.h"
+#include "../include/nn_optimizer.h"
+#include "../include/nn_quantization.h"
+#include "../include/neural_network.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+using utec::bench::do_not_optimize;
+
+namespace {
+
+using T = float;
+
+constexpr size_t kFeatures = 32;
+constexpr size_t kHidden = 256;
+constexpr size_t kTrainSamples = 4096;
+constexpr size_t kTestSamples = 2048;
+
+std::pair<Tensor<T, 2>, Tensor<T, 2>> make_data(size_t samples, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<T> dist(0.0f, 1.0f);
+    Tensor<T, 2> X(samples, kFeatures);
+    Tensor<T, 2> Y(samples, 1);
+    for (size_t i = 0; i < samples; ++i) {
+        for (size_t j = 0; j < kFeatures; ++j)
+            X(i, j) = dist(gen);
+        Y(i, 0) = (X(i, 0) * X(i, 1) + X(i, 2) > 0.0f) ? 1.0f : 0.0f;
+    }
+    return {X, Y};
+}
+
+double median_latency_ms(utec::bench::Runner& runner, const std::string& name,
+                         NeuralNetwork<T>& network, const Tensor<T, 2>& X) {
+    auto stats = runner.run(name, [&] { do_not_optimize(network.predict(X)); }, double(X.shape()[0]));
+    return stats ? stats->median_ns * 1e-6 : 0.0;
+}
+
+double accuracy(const Tensor<T, 2>& predictions, const Tensor<T, 2>& Y) {
+    size_t correct = 0;
+    for (size_t i = 0; i < Y.size(); ++i)
+        if ((predictions[i] > 0.5f) == (Y[i] > 0.5f)) ++correct;
+    return 100.0 * double(correct) / double(Y.size());
+}
+
+}
+
+int main(int argc, char** argv) {
+    utec::bench::Options options;
+    options.repetitions = 15;
+    utec::bench::Runner runner("quantization", argc, argv, options);
+
+    auto [X_train, Y_train] = make_data(kTrainSamples, 1);
+    auto [X_test, Y_test] = make_data(kTestSamples, 2);
+
+    NeuralNetwork<T> network;
+    network.add_dense_layer(kFeatures, kHidden);
+    network.add_relu_layer();
+    network.add_dense_layer(kHidden, kHidden);
+    network.add_relu_layer();
+    network.add_dense_layer(kHidden, 1);
+    network.add_sigmoid_layer();
+    network.train<BCELoss, SGD>(X_train, Y_train, 20, 64, 0.05f);
+
+    auto float_predictions = network.predict(X_test);
+    const double float_accuracy = accuracy(float_predictions, Y_test);
+    const double float_latency = median_latency_ms(runner, "predict/float", network, X_test);
+
+    Tensor<T, 2> calibration(512, kFeatures);
+    std::copy(X_train.cbegin(), X_train.cbegin() + calibration.size(), calibration.begin());
+    network.quantize(calibration);
+
+    auto int8_predictions = network.predict(X_test);
+    const double int8_accuracy = accuracy(int8_predictions, Y_test);
+    const double int8_latency = median_latency_ms(runner, "predict/int8", network, X_test);
+    runner.add_counter("accuracy_float", float_accuracy);
+    runner.add_counter("accuracy_int8", int8_accuracy);
+
+    double max_diff = 0.0;
+    size_t agreement = 0;
+    for (size_t i = 0; i < Y_test.size(); ++i) {
+        max_diff = std::max(max_diff, double(std::fabs(float_predictions[i] - int8_predictions[i])));
+        if ((float_predictions[i] > 0.5f) == (int8_predictions[i] > 0.5f)) ++agreement;
+    }
+
+    std::cout << "\nKernel int8: " << utec::neural_network::detail::int8_kernel_name() << '\n';
+    std::cout << "Arquitectura: " << kFeatures << " -> " << kHidden << " -> " << kHidden << " -> 1, "
+              << kTestSamples << " muestras de test\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(10) << "ruta" << std::right
+              << std::setw(16) << "latencia (ms)" << std::setw(16) << "precision (%)" << '\n';
+    std::cout << std::left << std::setw(10) << "float" << std::right
+              << std::setw(16) << float_latency << std::setw(16) << float_accuracy << '\n';
+    std::cout << std::left << std::setw(10) << "int8" << std::right
+              << std::setw(16) << int8_latency << std::setw(16) << int8_accuracy << '\n';
+    std::cout << "\nSpeedup: " << float_latency / int8_latency << "x\n";
+    std::cout << "Coincidencia de clases: " << 100.0 * double(agreement) / double(Y_test.size()) << "%\n";
+    std::cout << "Maxima diferencia absoluta: " << max_diff << '\n';
+    return runner.finish();
+}
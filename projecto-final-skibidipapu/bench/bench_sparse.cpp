@@ -0,0 +1,87 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "bench_harness.h"
+#include "../include/tensor.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_sparse.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+using utec::bench::do_not_optimize;
+
+namespace {
+
+using T = float;
+
+constexpr size_t kIn = 1024;
+constexpr size_t kOut = 1024;
+constexpr size_t kBatch = 128;
+double median_ms(utec::bench::Runner& runner, const std::string& name, Dense<T>& layer, const Tensor<T, 2>& X) {
+    auto stats = runner.run(name, [&] { do_not_optimize(layer.forward(X)); }, double(kBatch));
+    return stats ? stats->median_ns * 1e-6 : 0.0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    utec::bench::Options options;
+    options.warmup = 1;
+    options.repetitions = 7;
+    utec::bench::Runner runner("sparse", argc, argv, options);
+
+    std::mt19937 gen(7);
+    std::normal_distribution<T> dist(0.0f, 1.0f);
+    Tensor<T, 2> W(kIn, kOut);
+    for (auto& w : W) w = dist(gen);
+    Tensor<T, 2> X(kBatch, kIn);
+    for (auto& x : X) x = dist(gen);
+
+    auto copy_weights = [&W](Tensor<T, 2>& t) { t = W; };
+    auto zero = [](Tensor<T, 2>& t) { t.fill(0.0f); };
+
+    Dense<T> dense(kIn, kOut, copy_weights, zero);
+    dense.set_sparse_enabled(false);
+    const double dense_ms = median_ms(runner, "forward/dense", dense, X);
+    const size_t dense_bytes = dense.parameter_bytes();
+
+    std::vector<std::string> rows;
+    for (double target : {0.0, 0.5, 0.8, 0.9, 0.95}) {
+        Dense<T> layer(kIn, kOut, copy_weights, zero);
+        layer.prune(target);
+
+        Dense<T> reference(kIn, kOut, [&layer](Tensor<T, 2>& t) { t = layer.weights(); }, zero);
+        reference.set_sparse_enabled(false);
+        auto expected = reference.forward(X);
+        auto got = layer.forward(X);
+        double max_err = 0.0;
+        for (size_t i = 0; i < got.size(); ++i)
+            max_err = std::max(max_err, double(std::fabs(got[i] - expected[i])));
+
+        const double ms = median_ms(runner, "forward/sparsity_" + std::to_string(int(target * 100)), layer, X);
+        runner.add_counter("parameter_bytes", double(layer.parameter_bytes()));
+        std::ostringstream row;
+        row << std::fixed << std::left << std::setw(10) << std::setprecision(2) << target << std::right
+            << std::setw(12) << (layer.is_sparse() ? "CSR" : "denso")
+            << std::setw(14) << std::setprecision(3) << ms
+            << std::setw(14) << std::setprecision(2) << (ms > 0 ? dense_ms / ms : 0.0)
+            << std::setw(14) << layer.parameter_bytes() / 1024
+            << std::setw(12) << std::setprecision(6) << max_err;
+        rows.push_back(row.str());
+    }
+
+    std::cout << "\nDense " << kIn << " x " << kOut << ", batch " << kBatch << "\n\n";
+    std::cout << std::left << std::setw(10) << "sparsity" << std::right
+              << std::setw(12) << "modo" << std::setw(14) << "forward ms"
+              << std::setw(14) << "speedup" << std::setw(14) << "memoria KB"
+              << std::setw(12) << "max err" << '\n';
+    for (const auto& row : rows) std::cout << row << '\n';
+    std::cout << "\nReferencia densa: " << std::fixed << std::setprecision(3) << dense_ms << " ms, "
+              << dense_bytes / 1024 << " KB\n";
+    return runner.finish();
+}
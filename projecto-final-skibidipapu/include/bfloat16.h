@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <iostream>
+#include "tensor.h"
+
+namespace utec {
+namespace algebra {
+
+// Conversion por software (solo operaciones enteras), funciona en cualquier x86-64
+inline std::uint16_t float_to_bf16_bits(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<std::uint16_t>((bits >> 16) | 0x0040u);
+    }
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return static_cast<std::uint16_t>(bits >> 16);
+}
+
+inline float bf16_bits_to_float(std::uint16_t bits) noexcept {
+    std::uint32_t widened = static_cast<std::uint32_t>(bits) << 16;
+    float value;
+    std::memcpy(&value, &widened, sizeof(value));
+    return value;
+}
+
+class bfloat16 {
+    std::uint16_t bits_ = 0;
+
+public:
+    bfloat16() = default;
+    bfloat16(float value) noexcept : bits_(float_to_bf16_bits(value)) {}
+
+    static bfloat16 from_bits(std::uint16_t bits) noexcept {
+        bfloat16 result;
+        result.bits_ = bits;
+        return result;
+    }
+
+    std::uint16_t bits() const noexcept { return bits_; }
+
+    operator float() const noexcept { return bf16_bits_to_float(bits_); }
+
+    friend std::ostream& operator<<(std::ostream& os, const bfloat16& value) {
+        return os << static_cast<float>(value);
+    }
+};
+
+static_assert(sizeof(bfloat16) == 2, "bfloat16 must be 2 bytes");
+
+inline void convert(const float* src, bfloat16* dst, size_t n) noexcept {
+    #pragma omp parallel for simd if(n > 65536)
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = bfloat16::from_bits(float_to_bf16_bits(src[i]));
+    }
+}
+
+inline void convert(const bfloat16* src, float* dst, size_t n) noexcept {
+    #pragma omp parallel for simd if(n > 65536)
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = bf16_bits_to_float(src[i].bits());
+    }
+}
+
+template<typename From, typename To>
+void convert(const From* src, To* dst, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<To>(src[i]);
+    }
+}
+
+template<typename To, typename From, size_t Rank>
+Tensor<To, Rank> tensor_cast(const Tensor<From, Rank>& tensor) {
+    Tensor<To, Rank> result(tensor.shape());
+    convert(tensor.data(), result.data(), tensor.size());
+    return result;
+}
+
+}
+}
@@ -6,79 +6,414 @@
 #include "nn_loss.h"
 #include "nn_activation.h"
 #include "nn_dense.h"
+#include "nn_quantization.h"
+#include "nn_profiler.h"
+#include "tensor_reduce.h"
 #include <vector>
 #include <memory>
 #include <iostream>
 #include <chrono>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <limits>
 
 namespace utec::neural_network {
 
+    // Memoria de activaciones retenidas para backward frente al computo extra por paso
+    struct MemoryEstimate {
+        size_t batch_size = 0;
+        size_t activation_bytes = 0;
+        size_t baseline_bytes = 0;
+        double extra_compute = 0.0;
+    };
+
     template<typename T>
     class NeuralNetwork {
+        static constexpr size_t kNoSegment = static_cast<size_t>(-1);
+
         std::vector<std::unique_ptr<ILayer<T>>> layers_;
+        Profiler<T>* profiler_ = nullptr;
+        IGradientReducer<T>* reducer_ = nullptr;
+
+        // Segmentos [first, last) con checkpoint: solo se guarda su entrada y las
+        // activaciones internas se recalculan durante backward
+        std::vector<std::pair<size_t, size_t>> checkpoints_;
+        std::vector<utec::algebra::Tensor<T, 2>> checkpoint_inputs_;
+        size_t peak_cache_bytes_ = 0;
+        utec::algebra::Tensor<T, 2> loss_grad_;
+
+        template<typename F>
+        decltype(auto) profiled(size_t index, ProfilePhase phase, size_t rows, F&& body) {
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) {
+                    auto scope = profiler_->scope(layers_[index].get(), index, phase, rows);
+                    return body();
+                }
+            }
+            return body();
+        }
+
+        template<typename F>
+        decltype(auto) profiled_loss(size_t rows, F&& body) {
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) {
+                    auto scope = profiler_->loss_scope(rows);
+                    return body();
+                }
+            }
+            return body();
+        }
+
+        size_t segment_starting_at(size_t i) const {
+            for (size_t s = 0; s < checkpoints_.size(); ++s)
+                if (checkpoints_[s].first == i) return s;
+            return kNoSegment;
+        }
+
+        size_t segment_ending_at(size_t i) const {
+            for (size_t s = 0; s < checkpoints_.size(); ++s)
+                if (checkpoints_[s].second == i + 1) return s;
+            return kNoSegment;
+        }
+
+        size_t cached_bytes() const {
+            size_t total = 0;
+            for (const auto& layer : layers_) total += layer->cache_bytes();
+            for (const auto& input : checkpoint_inputs_) total += input.size() * sizeof(T);
+            return total;
+        }
+
+        utec::algebra::Tensor<T, 2> tracked_forward(size_t i, const utec::algebra::Tensor<T, 2>& input, size_t& live) {
+            const size_t before = layers_[i]->cache_bytes();
+            auto output = profiled(i, ProfilePhase::Forward, input.shape()[0],
+                                   [&] { return layers_[i]->forward(input); });
+            live = live - before + layers_[i]->cache_bytes();
+            peak_cache_bytes_ = std::max(peak_cache_bytes_, live);
+            return output;
+        }
+
+        void release_segment(size_t segment, size_t& live) {
+            for (size_t i = checkpoints_[segment].first; i < checkpoints_[segment].second; ++i) {
+                live -= layers_[i]->cache_bytes();
+                layers_[i]->release_cache();
+            }
+        }
+
+        void recompute_segment(size_t segment, size_t& live) {
+            const auto [first, last] = checkpoints_[segment];
+            auto activation = tracked_forward(first, checkpoint_inputs_[segment], live);
+            for (size_t i = first + 1; i < last; ++i)
+                activation = tracked_forward(i, activation, live);
+        }
+
+        // Costo relativo de forward por fila: FLOPs para Dense, elementos de salida para el resto
+        double forward_cost(size_t i, size_t output_elements) const {
+            if (auto* dense = dynamic_cast<const Dense<T>*>(layers_[i].get()))
+                return 2.0 * double(dense->nonzero_weights());
+            return double(output_elements);
+        }
+
+        void attach_profiler_layers() {
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) {
+                    std::vector<std::string> names;
+                    for (auto& layer : layers_) names.emplace_back(layer->name());
+                    profiler_->set_layers(names);
+                }
+            }
+        }
 
     public:
+        // Solo tiene efecto si se compila con UTEC_NN_PROFILING (opcion UTEC_ENABLE_PROFILING)
+        void set_profiler(Profiler<T>* profiler) {
+            profiler_ = profiler;
+        }
+
+        // Gradientes promediados entre procesos en cada paso (ver DataParallel en nn_distributed.h)
+        void set_gradient_reducer(IGradientReducer<T>* reducer) {
+            reducer_ = reducer;
+        }
+
         void add_layer(std::unique_ptr<ILayer<T>> layer) {
             layers_.push_back(std::move(layer));
         }
 
+        const std::vector<std::unique_ptr<ILayer<T>>>& layers() const {
+            return layers_;
+        }
+
+        // Marca las capas [first, last) como un segmento con checkpoint
+        void checkpoint_segment(size_t first, size_t last) {
+            if (first >= last || last > layers_.size()) {
+                throw std::invalid_argument("Checkpoint segment is out of range");
+            }
+            for (const auto& segment : checkpoints_) {
+                if (first < segment.second && segment.first < last) {
+                    throw std::invalid_argument("Checkpoint segments cannot overlap");
+                }
+            }
+            checkpoints_.emplace_back(first, last);
+            std::sort(checkpoints_.begin(), checkpoints_.end());
+            checkpoint_inputs_.assign(checkpoints_.size(), utec::algebra::Tensor<T, 2>());
+        }
+
+        // Segmentos consecutivos de `length` capas. El segmento con la ultima capa no se
+        // marca: sus activaciones se necesitan apenas empieza backward.
+        void checkpoint_every(size_t length) {
+            if (length == 0) {
+                throw std::invalid_argument("Checkpoint segment length must be positive");
+            }
+            clear_checkpoints();
+            for (size_t first = 0; first + length < layers_.size(); first += length)
+                checkpoint_segment(first, first + length);
+        }
+
+        void clear_checkpoints() {
+            checkpoints_.clear();
+            checkpoint_inputs_.clear();
+        }
+
+        const std::vector<std::pair<size_t, size_t>>& checkpoint_segments() const {
+            return checkpoints_;
+        }
+
+        // Pico de bytes retenidos para backward medido en la ultima llamada a train
+        size_t measured_peak_bytes() const {
+            return peak_cache_bytes_;
+        }
+
+        // Estimacion analitica a partir de la forma de cada capa (cache_bytes_for y
+        // planned_output_features): no ejecuta forward ni toca las activaciones guardadas
+        MemoryEstimate estimate_memory(size_t batch_size, size_t input_features) const {
+            const size_t L = layers_.size();
+            std::vector<size_t> cache(L), input_bytes(L);
+            std::vector<double> cost(L);
+            size_t features = input_features;
+            for (size_t i = 0; i < L; ++i) {
+                input_bytes[i] = batch_size * features * sizeof(T);
+                cache[i] = layers_[i]->cache_bytes_for(batch_size, features);
+                features = layers_[i]->planned_output_features(features);
+                cost[i] = forward_cost(i, features);
+            }
+
+            size_t baseline = 0;
+            double total_cost = 0;
+            for (size_t i = 0; i < L; ++i) {
+                baseline += cache[i];
+                total_cost += cost[i];
+            }
+
+            size_t kept = baseline, boundaries = 0, largest_segment = 0;
+            double recompute = 0;
+            for (const auto& [first, last] : checkpoints_) {
+                size_t segment_cache = 0;
+                for (size_t i = first; i < last; ++i) {
+                    segment_cache += cache[i];
+                    recompute += cost[i];
+                }
+                kept -= segment_cache;
+                boundaries += input_bytes[first];
+                largest_segment = std::max(largest_segment, segment_cache);
+            }
+
+            MemoryEstimate estimate;
+            estimate.batch_size = batch_size;
+            estimate.activation_bytes = kept + boundaries + largest_segment;
+            estimate.baseline_bytes = baseline;
+            // backward cuesta ~2x forward
+            estimate.extra_compute = total_cost > 0 ? recompute / (3.0 * total_cost) : 0.0;
+            return estimate;
+        }
+
+        // Mayor batch cuyas activaciones retenidas caben en budget_bytes. La mascara de ReLU
+        // redondea a palabras de 64 bits (no es lineal en el batch): se busca sobre la estimacion
+        size_t max_batch_size(size_t budget_bytes, size_t input_features) const {
+            auto fits = [&](size_t batch) {
+                return estimate_memory(batch, input_features).activation_bytes <= budget_bytes;
+            };
+            if (estimate_memory(1, input_features).activation_bytes == 0 || !fits(1)) return 0;
+            size_t low = 1, high = 2;
+            while (fits(high)) {
+                low = high;
+                if (high > std::numeric_limits<size_t>::max() / 2) return low;
+                high *= 2;
+            }
+            // fits(low) y !fits(high)
+            while (high - low > 1) {
+                const size_t middle = low + (high - low) / 2;
+                (fits(middle) ? low : high) = middle;
+            }
+            return low;
+        }
+
         template<template<typename...> class LossType = BCELoss, template<typename...> class OptimizerType = SGD>
         void train(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y,
                    const size_t epochs, const size_t batch_size, T lr) {
             OptimizerType<T> optimizer(lr);
+            peak_cache_bytes_ = 0;
+            auto last = std::chrono::high_resolution_clock::now();
+            for (size_t epoch = 0; epoch < epochs; ++epoch) {
+                const T epoch_loss = train_epoch<LossType>(X, Y, batch_size, optimizer, epoch);
+                // Mostrar progreso cada 50 épocas (sin flush: la E/S no frena el entrenamiento)
+                if ((epoch + 1) % 50 == 0 || epoch == 0) {
+                    auto now = std::chrono::high_resolution_clock::now();
+                    double elapsed = std::chrono::duration<double>(now - last).count();
+                    std::cout << "Epoca " << (epoch + 1) << " - Loss promedio: " << epoch_loss
+                              << " - Tiempo desde el ultimo avance: " << elapsed << " s\n";
+                    last = now;
+                }
+            }
+        }
+
+        // Una epoca sobre X en batches de batch_size; devuelve el promedio de las perdidas por batch.
+        // on_batch(salida, y_batch, perdida) recibe la salida de forward de cada batch, de modo que
+        // las metricas se acumulan sin otra pasada (ver nn_training.h).
+        template<template<typename...> class LossType = BCELoss, typename BatchObserver>
+        T train_epoch(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y,
+                      const size_t batch_size, IOptimizer<T>& optimizer, size_t epoch,
+                      BatchObserver&& on_batch) {
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
             size_t num_samples = X.shape()[0];
             size_t num_batches = (num_samples + batch_size - 1) / batch_size;
 
-            auto last = std::chrono::high_resolution_clock::now();
-            for (size_t epoch = 0; epoch < epochs; ++epoch) {
-                T epoch_loss = 0;
-                for (size_t batch = 0; batch < num_batches; ++batch) {
-                    size_t start = batch * batch_size;
-                    size_t end = std::min(start + batch_size, num_samples);
-                    size_t current_batch_size = end - start;
-
-                    // Crear batch de entrada y salida
-                    utec::algebra::Tensor<T,2> x_batch(current_batch_size, X.shape()[1]);
-                    utec::algebra::Tensor<T,2> y_batch(current_batch_size, Y.shape()[1]);
-                    for (size_t i = 0; i < current_batch_size; ++i) {
-                        for (size_t j = 0; j < X.shape()[1]; ++j)
-                            x_batch(i, j) = X(start + i, j);
-                        for (size_t j = 0; j < Y.shape()[1]; ++j)
-                            y_batch(i, j) = Y(start + i, j);
-                    }
+            attach_profiler_layers();
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) profiler_->begin_epoch(epoch);
+            }
+            utec::algebra::CompensatedSum<T> epoch_loss;
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                size_t start = batch * batch_size;
+                size_t end = std::min(start + batch_size, num_samples);
+                size_t current_batch_size = end - start;
+
+                // Crear batch de entrada y salida
+                utec::algebra::Tensor<T,2> x_batch(current_batch_size, X.shape()[1]);
+                utec::algebra::Tensor<T,2> y_batch(current_batch_size, Y.shape()[1]);
+                for (size_t i = 0; i < current_batch_size; ++i) {
+                    for (size_t j = 0; j < X.shape()[1]; ++j)
+                        x_batch(i, j) = X(start + i, j);
+                    for (size_t j = 0; j < Y.shape()[1]; ++j)
+                        y_batch(i, j) = Y(start + i, j);
+                }
 
-                    auto out = x_batch;
-                    for (auto& layer : layers_)
-                        out = layer->forward(out);
+                size_t live = cached_bytes();
+                auto out = x_batch;
+                for (size_t i = 0; i < layers_.size(); ++i) {
+                    const size_t segment = segment_starting_at(i);
+                    if (segment != kNoSegment) {
+                        checkpoint_inputs_[segment] = out;
+                        live += out.size() * sizeof(T);
+                    }
+                    out = tracked_forward(i, out, live);
+                    const size_t closing = segment_ending_at(i);
+                    if (closing != kNoSegment) release_segment(closing, live);
+                }
 
+                // La perdida escribe su gradiente en un buffer que se reutiliza entre batches
+                const T batch_loss = profiled_loss(current_batch_size, [&] {
                     LossType<T> loss(out, y_batch);
-                    epoch_loss += loss.loss();
-                    auto grad = loss.loss_gradient();
-
-                    for (auto it = layers_.rbegin(); it != layers_.rend(); ++it)
-                        grad = (*it)->backward(grad);
+                    return loss.compute(loss_grad_);
+                });
+                epoch_loss.add(batch_loss);
+                on_batch(static_cast<const utec::algebra::Tensor<T, 2>&>(out),
+                         static_cast<const utec::algebra::Tensor<T, 2>&>(y_batch), batch_loss);
 
-                    for (auto& layer : layers_)
-                        layer->update_params(optimizer);
+                const utec::algebra::Tensor<T, 2>* upstream = &loss_grad_;
+                utec::algebra::Tensor<T, 2> grad;
+                for (size_t i = layers_.size(); i-- > 0;) {
+                    const size_t closing = segment_ending_at(i);
+                    if (closing != kNoSegment) recompute_segment(closing, live);
+                    grad = profiled(i, ProfilePhase::Backward, current_batch_size,
+                                    [&] { return layers_[i]->backward(*upstream); });
+                    upstream = &grad;
+                    if (reducer_) reducer_->layer_ready(*layers_[i]);
+                    const size_t segment = segment_starting_at(i);
+                    if (segment != kNoSegment) {
+                        release_segment(segment, live);
+                        live -= checkpoint_inputs_[segment].size() * sizeof(T);
+                        checkpoint_inputs_[segment] = utec::algebra::Tensor<T, 2>();
+                    }
                 }
-                // Mostrar progreso cada 50 épocas
-                if ((epoch + 1) % 50 == 0 || epoch == 0) {
-                    auto now = std::chrono::high_resolution_clock::now();
-                    double elapsed = std::chrono::duration<double>(now - last).count();
-                    std::cout << "Epoca " << (epoch + 1) << " - Loss promedio: " << (epoch_loss / num_batches)
-                              << " - Tiempo desde el ultimo avance: " << elapsed << " s\n" << std::flush;
-                    last = now;
+
+                if (reducer_) reducer_->wait();
+                for (size_t i = 0; i < layers_.size(); ++i)
+                    profiled(i, ProfilePhase::Update, current_batch_size,
+                             [&] { layers_[i]->update_params(optimizer); });
+
+                if constexpr (kProfilingEnabled) {
+                    if (profiler_) profiler_->end_step();
                 }
             }
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) profiler_->end_epoch();
+            }
+            return epoch_loss.value() / num_batches;
+        }
+
+        template<template<typename...> class LossType = BCELoss>
+        T train_epoch(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y,
+                      const size_t batch_size, IOptimizer<T>& optimizer, size_t epoch = 0) {
+            return train_epoch<LossType>(X, Y, batch_size, optimizer, epoch,
+                                         [](const auto&, const auto&, T) {});
+        }
+
+        // Copia de la red con capas clonadas (pesos actuales, sin activaciones, perfilador
+        // ni checkpoints); sirve para evaluar en otro hilo mientras se sigue entrenando
+        NeuralNetwork snapshot() const {
+            NeuralNetwork copy;
+            for (const auto& layer : layers_)
+                copy.add_layer(layer->clone());
+            return copy;
         }
 
         utec::algebra::Tensor<T, 2> predict(const utec::algebra::Tensor<T, 2>& X) {
+            attach_profiler_layers();
             auto output = X;
-            for (auto& layer : layers_)
-                output = layer->forward(output);
+            for (size_t i = 0; i < layers_.size(); ++i)
+                output = profiled(i, ProfilePhase::Forward, X.shape()[0],
+                                  [&] { return layers_[i]->forward(output); });
+            if constexpr (kProfilingEnabled) {
+                if (profiler_) profiler_->end_step();
+            }
             return output;
         }
 
+        // Calibra las escalas de activacion pasando calibration_X por la red y reemplaza
+        // cada Dense por una QuantizedDense (fusionando la ReLU siguiente si existe)
+        void quantize(const utec::algebra::Tensor<T, 2>& calibration_X) {
+            std::vector<ActivationObserver<T>> observers(layers_.size());
+            auto output = calibration_X;
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                if (dynamic_cast<Dense<T>*>(layers_[i].get()))
+                    observers[i].observe(output);
+                output = layers_[i]->forward(output);
+            }
+
+            std::vector<std::unique_ptr<ILayer<T>>> quantized;
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                auto* dense = dynamic_cast<Dense<T>*>(layers_[i].get());
+                if (!dense) {
+                    quantized.push_back(std::move(layers_[i]));
+                    continue;
+                }
+                bool fuse_relu = i + 1 < layers_.size() && dynamic_cast<ReLU<T>*>(layers_[i + 1].get());
+                quantized.push_back(std::make_unique<QuantizedDense<T>>(*dense, observers[i].params(), fuse_relu));
+                if (fuse_relu) ++i;
+            }
+            layers_ = std::move(quantized);
+            clear_checkpoints();
+        }
+
+        void prune(double sparsity) {
+            for (auto& layer : layers_)
+                if (auto* dense = dynamic_cast<Dense<T>*>(layer.get()))
+                    dense->prune(sparsity);
+        }
+
         void add_dense_layer(size_t in_features, size_t out_features) {
             add_layer(std::make_unique<Dense<T>>(in_features, out_features));
         }
@@ -3,91 +3,223 @@
 
 #include "nn_interfaces.h"
 #include "tensor.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 
 namespace utec::neural_network {
 
+    // Backward solo necesita saber que elementos pasaron: se guarda una mascara de 1 bit
+    // por elemento empaquetada en palabras de 64 bits (64 veces menos que un Tensor<double>)
     template<typename T>
     class ReLU final : public ILayer<T> {
     private:
-        utec::algebra::Tensor<T, 2> z_;
+        static constexpr size_t kBits = 64;
+        std::vector<std::uint64_t> mask_;
+        size_t elements_ = 0;
+
+        static size_t words(size_t elements) { return (elements + kBits - 1) / kBits; }
+
+        // La salida se escribe en un bucle aparte (vectorizable) y la mascara se arma de a
+        // 8 bits con desplazamientos constantes, sin saltos que dependan de los datos
+        static std::uint64_t pack_word(const T* in, T* out, size_t count) {
+            for (size_t b = 0; b < count; ++b)
+                out[b] = std::max(T(0), in[b]);
+            std::uint64_t word = 0;
+            for (size_t b = 0; b < count; b += 8) {
+                unsigned byte = 0;
+                for (unsigned k = 0; k < 8 && b + k < count; ++k)
+                    byte |= unsigned(in[b + k] > T(0)) << k;
+                word |= std::uint64_t(byte) << b;
+            }
+            return word;
+        }
+
+        // Multiplicar por el bit evita el salto por elemento (un select con datos aleatorios falla la prediccion)
+        static void unpack_word(std::uint64_t word, const T* g, T* out, size_t count) {
+            for (size_t b = 0; b < count; ++b)
+                out[b] = g[b] * T((word >> b) & 1u);
+        }
+
     public:
         ReLU() = default;
+        const char* name() const override { return "ReLU"; }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<ReLU<T>>(); }
+        size_t cache_bytes() const override { return mask_.size() * sizeof(std::uint64_t); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override {
+            return words(rows * features) * sizeof(std::uint64_t);
+        }
+        void release_cache() override {
+            std::vector<std::uint64_t>().swap(mask_);
+            elements_ = 0;
+        }
+
         utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& z) override {
-            z_ = z;
-            utec::algebra::Tensor<T, 2> result = z;
-            for (size_t i = 0; i < result.size(); ++i)
-                result[i] = std::max(T(0), z[i]);
+            utec::algebra::Tensor<T, 2> result(z.shape());
+            const T* in = z.data();
+            T* out = result.data();
+            elements_ = z.size();
+            mask_.resize(words(elements_));
+
+            // Las palabras completas usan count constante para que el compilador desenrolle
+            #pragma omp parallel for
+            for (size_t w = 0; w < mask_.size(); ++w) {
+                const size_t begin = w * kBits;
+                if (begin + kBits <= elements_) {
+                    mask_[w] = pack_word(in + begin, out + begin, kBits);
+                } else {
+                    mask_[w] = pack_word(in + begin, out + begin, elements_ - begin);
+                }
+            }
             return result;
         }
 
         utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& grad) override {
-            utec::algebra::Tensor<T, 2> dz = grad;
-            for (size_t i = 0; i < dz.size(); ++i)
-                dz[i] = (z_[i] > 0) ? grad[i] : T(0);
+            if (grad.size() != elements_) {
+                throw std::invalid_argument("Gradient shape does not match the last ReLU forward");
+            }
+            utec::algebra::Tensor<T, 2> dz(grad.shape());
+            const T* g = grad.data();
+            T* out = dz.data();
+
+            #pragma omp parallel for
+            for (size_t w = 0; w < mask_.size(); ++w) {
+                const size_t begin = w * kBits;
+                if (begin + kBits <= elements_) {
+                    unpack_word(mask_[w], g + begin, out + begin, kBits);
+                } else {
+                    unpack_word(mask_[w], g + begin, out + begin, elements_ - begin);
+                }
+            }
             return dz;
         }
+
+        bool supports_planning() const override { return true; }
+        bool backward_uses_output() const override { return true; }
+
+        void forward_planned(const T* X, T* Y, size_t rows, size_t features) override {
+            for (size_t i = 0; i < rows * features; ++i)
+                Y[i] = std::max(T(0), X[i]);
+        }
+
+        // Y > 0 exactamente cuando X > 0
+        void backward_planned(const T*, const T* Y, const T* dY, T* dX, size_t rows, size_t features) override {
+            if (!dX) return;
+            for (size_t i = 0; i < rows * features; ++i)
+                dX[i] = dY[i] * T(Y[i] > T(0));
+        }
     };
 
+    // Se guarda la salida: sigma'(x) = y * (1 - y) sin volver a evaluar exp en backward
     template<typename T>
     class Sigmoid final : public ILayer<T> {
-        utec::algebra::Tensor<T, 2> input_;
+        utec::algebra::Tensor<T, 2> output_;
 
     public:
         Sigmoid() = default;
+        const char* name() const override { return "Sigmoid"; }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Sigmoid<T>>(); }
+        size_t cache_bytes() const override { return output_.size() * sizeof(T); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override { return rows * features * sizeof(T); }
+        void release_cache() override { output_ = utec::algebra::Tensor<T, 2>(); }
+
         utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& input) override {
-            input_ = input;
-            auto output = input;
-            for (size_t i = 0; i < output.size(); ++i)
-                output[i] = T(1) / (T(1) + std::exp(-input[i]));
-            return output;
+            output_ = utec::algebra::Tensor<T, 2>(input.shape());
+            forward_planned(input.data(), output_.data(), input.shape()[0], input.shape()[1]);
+            return output_;
         }
 
         utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& grad) override {
-            auto grad_output = grad;
-            for (size_t i = 0; i < input_.size(); ++i) {
-                T sig = T(1) / (T(1) + std::exp(-input_[i]));
-                grad_output[i] = grad[i] * sig * (T(1) - sig);
+            if (grad.shape() != output_.shape()) {
+                throw std::invalid_argument("Gradient shape does not match the last Sigmoid forward");
             }
-            return grad_output;
+            utec::algebra::Tensor<T, 2> dX(grad.shape());
+            backward_planned(nullptr, output_.data(), grad.data(), dX.data(), grad.shape()[0], grad.shape()[1]);
+            return dX;
+        }
+
+        bool supports_planning() const override { return true; }
+        bool backward_uses_output() const override { return true; }
+
+        void forward_planned(const T* X, T* Y, size_t rows, size_t features) override {
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows * features; ++i)
+                Y[i] = T(1) / (T(1) + std::exp(-X[i]));
+        }
+
+        void backward_planned(const T*, const T* Y, const T* dY, T* dX, size_t rows, size_t features) override {
+            if (!dX) return;
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows * features; ++i)
+                dX[i] = dY[i] * Y[i] * (T(1) - Y[i]);
         }
     };
 
     template<typename T>
     class Softmax final : public ILayer<T> {
-        utec::algebra::Tensor<T, 2> input_;
+        utec::algebra::Tensor<T, 2> output_;
 
     public:
         Softmax() = default;
+        const char* name() const override { return "Softmax"; }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Softmax<T>>(); }
+        size_t cache_bytes() const override { return output_.size() * sizeof(T); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override { return rows * features * sizeof(T); }
+        void release_cache() override { output_ = utec::algebra::Tensor<T, 2>(); }
+
         utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& input) override {
-            input_ = input;
-            auto output = input;
-            
-            size_t num_samples = input.shape()[0];
-            size_t num_classes = input.shape()[1];
-            
-            for (size_t sample = 0; sample < num_samples; ++sample) {
-                T max_val = input(sample, 0);
-                for (size_t j = 1; j < num_classes; ++j) {
-                    max_val = std::max(max_val, input(sample, j));
-                }
-                
+            output_ = utec::algebra::Tensor<T, 2>(input.shape());
+            forward_planned(input.data(), output_.data(), input.shape()[0], input.shape()[1]);
+            return output_;
+        }
+
+        utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& grad) override {
+            if (grad.shape() != output_.shape()) {
+                throw std::invalid_argument("Gradient shape does not match the last Softmax forward");
+            }
+            utec::algebra::Tensor<T, 2> dX(grad.shape());
+            backward_planned(nullptr, output_.data(), grad.data(), dX.data(), grad.shape()[0], grad.shape()[1]);
+            return dX;
+        }
+
+        bool supports_planning() const override { return true; }
+        bool backward_uses_output() const override { return true; }
+
+        void forward_planned(const T* X, T* Y, size_t rows, size_t features) override {
+            #pragma omp parallel for
+            for (size_t sample = 0; sample < rows; ++sample) {
+                const T* x = X + sample * features;
+                T* y = Y + sample * features;
+                T max_val = x[0];
+                for (size_t j = 1; j < features; ++j)
+                    max_val = std::max(max_val, x[j]);
+
                 T sum = T(0);
-                for (size_t j = 0; j < num_classes; ++j) {
-                    output(sample, j) = std::exp(input(sample, j) - max_val);
-                    sum += output(sample, j);
-                }
-                
-                for (size_t j = 0; j < num_classes; ++j) {
-                    output(sample, j) /= sum;
+                for (size_t j = 0; j < features; ++j) {
+                    y[j] = std::exp(x[j] - max_val);
+                    sum += y[j];
                 }
+                for (size_t j = 0; j < features; ++j)
+                    y[j] /= sum;
             }
-            
-            return output;
         }
 
-        utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& grad) override {
-            return grad;
+        // Jacobiano de softmax por fila: dX_j = y_j * (dY_j - sum_k dY_k * y_k)
+        void backward_planned(const T*, const T* Y, const T* dY, T* dX, size_t rows, size_t features) override {
+            if (!dX) return;
+            #pragma omp parallel for
+            for (size_t sample = 0; sample < rows; ++sample) {
+                const T* y = Y + sample * features;
+                const T* dy = dY + sample * features;
+                T* dx = dX + sample * features;
+                T dot = T(0);
+                for (size_t j = 0; j < features; ++j)
+                    dot += dy[j] * y[j];
+                for (size_t j = 0; j < features; ++j)
+                    dx[j] = y[j] * (dy[j] - dot);
+            }
         }
     };
 }
@@ -0,0 +1,422 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_CONV_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_CONV_H
+
+#include "nn_interfaces.h"
+#include "tensor.h"
+#include "tensor_random.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace utec::neural_network {
+
+    // Las capas siguen trabajando con Tensor<T, 2>: cada fila es una muestra NCHW aplanada
+    // (C * H * W columnas), asi Conv2D y MaxPool2D se combinan con Dense en NeuralNetwork.
+    // flatten_images / to_images convierten desde y hacia Tensor<T, 4>.
+    struct ImageShape {
+        size_t channels = 1, height = 1, width = 1;
+
+        size_t size() const { return channels * height * width; }
+        size_t plane() const { return height * width; }
+        bool operator==(const ImageShape& other) const {
+            return channels == other.channels && height == other.height && width == other.width;
+        }
+    };
+
+    template<typename T>
+    utec::algebra::Tensor<T, 2> flatten_images(const utec::algebra::Tensor<T, 4>& images) {
+        const auto& shape = images.shape();
+        utec::algebra::Tensor<T, 2> rows(shape[0], shape[1] * shape[2] * shape[3]);
+        std::copy(images.cbegin(), images.cend(), rows.begin());
+        return rows;
+    }
+
+    template<typename T>
+    utec::algebra::Tensor<T, 4> to_images(const utec::algebra::Tensor<T, 2>& rows, ImageShape shape) {
+        if (rows.shape()[1] != shape.size()) {
+            throw std::invalid_argument("Row width does not match the image shape");
+        }
+        utec::algebra::Tensor<T, 4> images(rows.shape()[0], shape.channels, shape.height, shape.width);
+        std::copy(rows.cbegin(), rows.cend(), images.begin());
+        return images;
+    }
+
+    namespace detail {
+
+        inline size_t pooled_extent(size_t input, size_t window, size_t stride, size_t padding) {
+            if (stride == 0 || window == 0 || input + 2 * padding < window) {
+                throw std::invalid_argument("Window does not fit in the input");
+            }
+            return (input + 2 * padding - window) / stride + 1;
+        }
+
+        // Geometria de una convolucion cuadrada (kernel, stride y padding iguales en ambos ejes)
+        struct ConvGeometry {
+            ImageShape input, output;
+            size_t kernel = 1, stride = 1, padding = 0;
+
+            size_t patch() const { return input.channels * kernel * kernel; }
+
+            // Fila (c, ky, kx) de la matriz de columnas: rango de ox cuya entrada cae dentro de la imagen
+            void valid_columns(size_t kx, size_t& first, size_t& last) const {
+                first = kx >= padding ? 0 : (padding - kx + stride - 1) / stride;
+                // ix = ox * stride + kx - padding < width
+                const size_t limit = kx >= input.width + padding ? 0 : input.width + padding - kx;
+                last = std::min(output.width, (limit + stride - 1) / stride);
+                first = std::min(first, last);
+            }
+        };
+
+        // cols (patch x OH*OW) a partir de una muestra CHW; los puntos del padding quedan en 0
+        template<typename T>
+        void im2col(const T* x, const ConvGeometry& g, T* cols) {
+            const size_t k = g.kernel, out_plane = g.output.plane();
+            for (size_t c = 0; c < g.input.channels; ++c)
+                for (size_t ky = 0; ky < k; ++ky)
+                    for (size_t kx = 0; kx < k; ++kx) {
+                        T* row = cols + ((c * k + ky) * k + kx) * out_plane;
+                        size_t first, last;
+                        g.valid_columns(kx, first, last);
+                        for (size_t oy = 0; oy < g.output.height; ++oy) {
+                            T* out = row + oy * g.output.width;
+                            const size_t iy = oy * g.stride + ky;
+                            if (iy < g.padding || iy - g.padding >= g.input.height) {
+                                std::fill(out, out + g.output.width, T(0));
+                                continue;
+                            }
+                            const T* in = x + (c * g.input.height + iy - g.padding) * g.input.width;
+                            std::fill(out, out + first, T(0));
+                            for (size_t ox = first; ox < last; ++ox)
+                                out[ox] = in[ox * g.stride + kx - g.padding];
+                            std::fill(out + last, out + g.output.width, T(0));
+                        }
+                    }
+        }
+
+        // Inversa de im2col acumulando: dx (CHW, ya en cero) += aporte de cada columna
+        template<typename T>
+        void col2im(const T* cols, const ConvGeometry& g, T* dx) {
+            const size_t k = g.kernel, out_plane = g.output.plane();
+            for (size_t c = 0; c < g.input.channels; ++c)
+                for (size_t ky = 0; ky < k; ++ky)
+                    for (size_t kx = 0; kx < k; ++kx) {
+                        const T* row = cols + ((c * k + ky) * k + kx) * out_plane;
+                        size_t first, last;
+                        g.valid_columns(kx, first, last);
+                        for (size_t oy = 0; oy < g.output.height; ++oy) {
+                            const size_t iy = oy * g.stride + ky;
+                            if (iy < g.padding || iy - g.padding >= g.input.height) continue;
+                            T* in = dx + (c * g.input.height + iy - g.padding) * g.input.width;
+                            const T* out = row + oy * g.output.width;
+                            for (size_t ox = first; ox < last; ++ox)
+                                in[ox * g.stride + kx - g.padding] += out[ox];
+                        }
+                    }
+        }
+
+    }
+
+    // Convolucion 2D por im2col: por muestra, Y (OC x OH*OW) = W (OC x C*k*k) * cols.
+    // Las muestras se reparten entre hilos (cada uno con su buffer de columnas); con una sola
+    // muestra el GEMM reparte los canales de salida.
+    template<typename T>
+    class Conv2D : public ILayer<T> {
+        // Los gradientes de W se acumulan en tramos fijos del batch y se suman en orden:
+        // el resultado no depende del numero de hilos
+        static constexpr size_t kGradientLanes = 16;
+
+        detail::ConvGeometry geometry_;
+        utec::algebra::Tensor<T, 2> W_, b_;
+        utec::algebra::Tensor<T, 2> grad_W_, grad_b_;
+        utec::algebra::Tensor<T, 2> input_;
+        // Memoria de trabajo de backward, reservada al construir: parciales por tramo y, por
+        // hilo, columnas, gradiente de columnas y dW de una muestra
+        std::vector<T> partial_W_, partial_b_, workspace_;
+
+        size_t workspace_per_thread() const {
+            return 2 * geometry_.patch() * geometry_.output.plane() + geometry_.output.channels * geometry_.patch();
+        }
+
+        static size_t max_threads() {
+#ifdef _OPENMP
+            return size_t(omp_get_max_threads());
+#else
+            return 1;
+#endif
+        }
+
+        static size_t thread_index() {
+#ifdef _OPENMP
+            return size_t(omp_get_thread_num());
+#else
+            return 0;
+#endif
+        }
+
+        void check_input(size_t features) const {
+            if (features != geometry_.input.size()) {
+                throw std::invalid_argument("Input features do not match the Conv2D input shape");
+            }
+        }
+
+    public:
+        using InitFunction = std::function<void(utec::algebra::Tensor<T, 2>&)>;
+
+        Conv2D(ImageShape input, size_t out_channels, size_t kernel, size_t stride = 1, size_t padding = 0) {
+            geometry_.input = input;
+            geometry_.kernel = kernel;
+            geometry_.stride = stride;
+            geometry_.padding = padding;
+            geometry_.output = {out_channels, detail::pooled_extent(input.height, kernel, stride, padding),
+                                detail::pooled_extent(input.width, kernel, stride, padding)};
+            W_ = utec::algebra::Tensor<T, 2>(out_channels, geometry_.patch());
+            b_ = utec::algebra::Tensor<T, 2>(1, out_channels);
+            grad_W_ = utec::algebra::Tensor<T, 2>(out_channels, geometry_.patch());
+            grad_b_ = utec::algebra::Tensor<T, 2>(1, out_channels);
+            partial_W_.resize(kGradientLanes * out_channels * geometry_.patch());
+            partial_b_.resize(kGradientLanes * out_channels);
+            workspace_.resize(max_threads() * workspace_per_thread());
+            // Xavier con fan_in = C*k*k y fan_out = OC*k*k
+            const T fan = T(geometry_.patch() + out_channels * kernel * kernel);
+            utec::algebra::fill_normal(W_, T(0), std::sqrt(T(2) / fan));
+            b_.fill(T(0));
+        }
+
+        Conv2D(ImageShape input, size_t out_channels, size_t kernel, size_t stride, size_t padding,
+               InitFunction init_w, InitFunction init_b)
+                : Conv2D(input, out_channels, kernel, stride, padding) {
+            init_w(W_);
+            init_b(b_);
+        }
+
+        utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& X) override {
+            check_input(X.shape()[1]);
+            input_ = X;
+            utec::algebra::Tensor<T, 2> Y(X.shape()[0], geometry_.output.size());
+            forward_planned(X.data(), Y.data(), X.shape()[0], X.shape()[1]);
+            return Y;
+        }
+
+        utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& dY) override {
+            if (dY.shape()[0] != input_.shape()[0] || dY.shape()[1] != geometry_.output.size()) {
+                throw std::invalid_argument("Gradient shape does not match the Conv2D output");
+            }
+            utec::algebra::Tensor<T, 2> dX(dY.shape()[0], geometry_.input.size());
+            backward_planned(input_.data(), nullptr, dY.data(), dX.data(), dY.shape()[0], geometry_.input.size());
+            return dX;
+        }
+
+        bool supports_planning() const override { return true; }
+        bool backward_uses_input() const override { return true; }
+
+        size_t planned_output_features(size_t features) const override {
+            check_input(features);
+            return geometry_.output.size();
+        }
+
+        // El buffer de columnas es por hilo (thread_local) y no un miembro: forward_planned debe
+        // poder correr a la vez desde varios hilos sobre la misma capa (lectores de
+        // OnlineLearner). Solo se reserva la primera vez que un hilo ve una capa mas grande.
+        void forward_planned(const T* X, T* Y, size_t rows, size_t) override {
+            const auto& g = geometry_;
+            const size_t oc = g.output.channels, plane = g.output.plane();
+
+            #pragma omp parallel if(rows > 1)
+            {
+                thread_local std::vector<T> cols;
+                if (cols.size() < g.patch() * plane) cols.resize(g.patch() * plane);
+                #pragma omp for schedule(static)
+                for (size_t n = 0; n < rows; ++n) {
+                    T* y = Y + n * g.output.size();
+                    detail::im2col(X + n * g.input.size(), g, cols.data());
+                    utec::algebra::detail::gemm(W_.data(), cols.data(), y, oc, g.patch(), plane);
+                    for (size_t c = 0; c < oc; ++c)
+                        for (size_t i = 0; i < plane; ++i) y[c * plane + i] += b_[c];
+                }
+            }
+        }
+
+        void backward_planned(const T* X, const T*, const T* dY, T* dX, size_t rows, size_t) override {
+            const auto& g = geometry_;
+            const size_t oc = g.output.channels, plane = g.output.plane(), patch = g.patch();
+            if (rows == 0) {
+                grad_W_.fill(T(0));
+                grad_b_.fill(T(0));
+                return;
+            }
+            const size_t lanes = std::min(rows, kGradientLanes);
+            std::fill(partial_W_.begin(), partial_W_.begin() + std::ptrdiff_t(lanes * oc * patch), T(0));
+            std::fill(partial_b_.begin(), partial_b_.begin() + std::ptrdiff_t(lanes * oc), T(0));
+            // Solo crece si ahora hay mas hilos que al construir la capa
+            const size_t per_thread = workspace_per_thread();
+            if (workspace_.size() < max_threads() * per_thread) workspace_.resize(max_threads() * per_thread);
+
+            #pragma omp parallel if(rows > 1)
+            {
+                T* cols = workspace_.data() + thread_index() * per_thread;
+                T* dcols = cols + patch * plane;
+                T* dW = dcols + patch * plane;
+                #pragma omp for schedule(static)
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    T* lane_W = partial_W_.data() + lane * oc * patch;
+                    T* lane_b = partial_b_.data() + lane * oc;
+                    for (size_t n = rows * lane / lanes; n < rows * (lane + 1) / lanes; ++n) {
+                        const T* dy = dY + n * g.output.size();
+                        detail::im2col(X + n * g.input.size(), g, cols);
+                        // dW += dY_n * cols^T
+                        utec::algebra::detail::gemm_nt(dy, cols, dW, oc, plane, patch);
+                        for (size_t i = 0; i < oc * patch; ++i) lane_W[i] += dW[i];
+                        for (size_t c = 0; c < oc; ++c)
+                            for (size_t i = 0; i < plane; ++i) lane_b[c] += dy[c * plane + i];
+                        if (dX) {
+                            // dcols = W^T * dY_n, devuelto a la imagen con col2im
+                            utec::algebra::detail::gemm_tn(W_.data(), dy, dcols, oc, patch, plane);
+                            T* dx = dX + n * g.input.size();
+                            std::fill(dx, dx + g.input.size(), T(0));
+                            detail::col2im(dcols, g, dx);
+                        }
+                    }
+                }
+            }
+
+            std::copy(partial_W_.begin(), partial_W_.begin() + std::ptrdiff_t(oc * patch), grad_W_.begin());
+            std::copy(partial_b_.begin(), partial_b_.begin() + std::ptrdiff_t(oc), grad_b_.begin());
+            for (size_t lane = 1; lane < lanes; ++lane) {
+                for (size_t i = 0; i < oc * patch; ++i) grad_W_[i] += partial_W_[lane * oc * patch + i];
+                for (size_t c = 0; c < oc; ++c) grad_b_[c] += partial_b_[lane * oc + c];
+            }
+        }
+
+        void update_params(IOptimizer<T>& optimizer) override {
+            optimizer.update(W_, grad_W_);
+            optimizer.update(b_, grad_b_);
+        }
+
+        const char* name() const override { return "Conv2D"; }
+        std::unique_ptr<ILayer<T>> clone() const override {
+            auto copy = std::make_unique<Conv2D<T>>(*this);
+            copy->release_cache();
+            return copy;
+        }
+
+        size_t cache_bytes() const override { return input_.size() * sizeof(T); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override { return rows * features * sizeof(T); }
+        void release_cache() override { input_ = utec::algebra::Tensor<T, 2>(); }
+
+        ImageShape input_shape() const { return geometry_.input; }
+        ImageShape output_shape() const { return geometry_.output; }
+        // Filtros como matriz OC x (C * k * k)
+        const utec::algebra::Tensor<T, 2>& weights() const { return W_; }
+        const utec::algebra::Tensor<T, 2>& bias() const { return b_; }
+    };
+
+    // Max pooling por canal. Backward vuelve a buscar el maximo de cada ventana en la entrada
+    // guardada (el primero ante empates) en lugar de guardar indices.
+    template<typename T>
+    class MaxPool2D : public ILayer<T> {
+        ImageShape input_shape_, output_shape_;
+        size_t window_, stride_;
+        utec::algebra::Tensor<T, 2> input_;
+
+        void check_input(size_t features) const {
+            if (features != input_shape_.size()) {
+                throw std::invalid_argument("Input features do not match the MaxPool2D input shape");
+            }
+        }
+
+        // Desplazamiento (dentro del plano) del maximo de la ventana de salida (oy, ox)
+        size_t window_argmax(const T* plane, size_t oy, size_t ox) const {
+            size_t best = oy * stride_ * input_shape_.width + ox * stride_;
+            for (size_t ky = 0; ky < window_; ++ky) {
+                const size_t row = (oy * stride_ + ky) * input_shape_.width + ox * stride_;
+                for (size_t kx = 0; kx < window_; ++kx)
+                    if (plane[row + kx] > plane[best]) best = row + kx;
+            }
+            return best;
+        }
+
+    public:
+        explicit MaxPool2D(ImageShape input, size_t window = 2, size_t stride = 0)
+                : input_shape_(input), window_(window), stride_(stride ? stride : window) {
+            output_shape_ = {input.channels, detail::pooled_extent(input.height, window_, stride_, 0),
+                             detail::pooled_extent(input.width, window_, stride_, 0)};
+        }
+
+        utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& X) override {
+            check_input(X.shape()[1]);
+            input_ = X;
+            utec::algebra::Tensor<T, 2> Y(X.shape()[0], output_shape_.size());
+            forward_planned(X.data(), Y.data(), X.shape()[0], X.shape()[1]);
+            return Y;
+        }
+
+        utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& dY) override {
+            if (dY.shape()[0] != input_.shape()[0] || dY.shape()[1] != output_shape_.size()) {
+                throw std::invalid_argument("Gradient shape does not match the MaxPool2D output");
+            }
+            utec::algebra::Tensor<T, 2> dX(dY.shape()[0], input_shape_.size());
+            backward_planned(input_.data(), nullptr, dY.data(), dX.data(), dY.shape()[0], input_shape_.size());
+            return dX;
+        }
+
+        bool supports_planning() const override { return true; }
+        bool backward_uses_input() const override { return true; }
+
+        size_t planned_output_features(size_t features) const override {
+            check_input(features);
+            return output_shape_.size();
+        }
+
+        // Un plano (muestra, canal) por iteracion
+        void forward_planned(const T* X, T* Y, size_t rows, size_t) override {
+            const size_t planes = rows * input_shape_.channels;
+            const size_t in_plane = input_shape_.plane(), out_plane = output_shape_.plane();
+            #pragma omp parallel for if(planes * in_plane >= (size_t(1) << 14))
+            for (size_t p = 0; p < planes; ++p) {
+                const T* x = X + p * in_plane;
+                T* y = Y + p * out_plane;
+                for (size_t oy = 0; oy < output_shape_.height; ++oy)
+                    for (size_t ox = 0; ox < output_shape_.width; ++ox)
+                        y[oy * output_shape_.width + ox] = x[window_argmax(x, oy, ox)];
+            }
+        }
+
+        void backward_planned(const T* X, const T*, const T* dY, T* dX, size_t rows, size_t) override {
+            if (!dX) return;
+            const size_t planes = rows * input_shape_.channels;
+            const size_t in_plane = input_shape_.plane(), out_plane = output_shape_.plane();
+            #pragma omp parallel for if(planes * in_plane >= (size_t(1) << 14))
+            for (size_t p = 0; p < planes; ++p) {
+                const T* x = X + p * in_plane;
+                const T* dy = dY + p * out_plane;
+                T* dx = dX + p * in_plane;
+                std::fill(dx, dx + in_plane, T(0));
+                // Con ventanas solapadas (stride < window) un mismo punto recibe varios aportes
+                for (size_t oy = 0; oy < output_shape_.height; ++oy)
+                    for (size_t ox = 0; ox < output_shape_.width; ++ox)
+                        dx[window_argmax(x, oy, ox)] += dy[oy * output_shape_.width + ox];
+            }
+        }
+
+        const char* name() const override { return "MaxPool2D"; }
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<MaxPool2D<T>>(input_shape_, window_, stride_);
+        }
+
+        size_t cache_bytes() const override { return input_.size() * sizeof(T); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override { return rows * features * sizeof(T); }
+        void release_cache() override { input_ = utec::algebra::Tensor<T, 2>(); }
+
+        ImageShape input_shape() const { return input_shape_; }
+        ImageShape output_shape() const { return output_shape_; }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_CONV_H
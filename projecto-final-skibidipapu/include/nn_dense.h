@@ -4,18 +4,36 @@
 #include <functional>
 #include "nn_interfaces.h"
 #include "tensor.h"
+#include "tensor_random.h"
+#include "nn_sparse.h"
 #include <numeric>
-#include <random>
+#include <cmath>
+#include <optional>
 
 using utec::algebra::Tensor;
 
 namespace utec::neural_network {
 
+    // Reproducible con utec::algebra::set_global_seed: cada llamada toma el siguiente flujo Philox
+    template<typename T>
+    void xavier_normal_init(Tensor<T, 2>& tensor) {
+        T scale = std::sqrt(T(2.0) / (tensor.shape()[0] + tensor.shape()[1]));
+        utec::algebra::fill_normal(tensor, T(0), scale);
+    }
+
     template<typename T>
     class Dense : public ILayer<T> {
         Tensor<T, 2> W_, b_;
         Tensor<T, 2> input_;
         Tensor<T, 2> grad_W_, grad_b_;
+        size_t in_features_, out_features_;
+
+        // Con sparsity >= sparse_threshold_ los pesos pasan a CSR y W_ / grad_W_ se liberan
+        // (salvo que set_sparse_enabled(false) fije el almacenamiento denso)
+        std::optional<CsrMatrix<T>> sparse_W_;
+        Tensor<T, 2> grad_values_;
+        double sparse_threshold_ = 0.8;
+        bool sparse_enabled_ = true;
 
     public:
         using InitFunction = std::function<void(Tensor<T, 2>&)>;
@@ -25,7 +43,9 @@ namespace utec::neural_network {
                 : W_(in_features, out_features),
                   b_(1, out_features),
                   grad_W_(in_features, out_features),
-                  grad_b_(1, out_features) {
+                  grad_b_(1, out_features),
+                  in_features_(in_features),
+                  out_features_(out_features) {
             init_w(W_);
             init_b(b_);
         }
@@ -34,41 +54,164 @@ namespace utec::neural_network {
                 : W_(in_features, out_features),
                   b_(1, out_features),
                   grad_W_(in_features, out_features),
-                  grad_b_(1, out_features) {
-            auto xavier_init = [](Tensor<T, 2>& tensor) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                T scale = std::sqrt(T(2.0) / (tensor.shape()[0] + tensor.shape()[1]));
-                std::normal_distribution<T> dist(T(0), scale);
-                
-                for (size_t i = 0; i < tensor.size(); ++i) {
-                    tensor[i] = dist(gen);
-                }
-            };
-            
-            auto zero_init = [](Tensor<T, 2>& tensor) {
-                tensor.fill(T(0));
-            };
-            
-            xavier_init(W_);
-            zero_init(b_);
+                  grad_b_(1, out_features),
+                  in_features_(in_features),
+                  out_features_(out_features) {
+            xavier_normal_init(W_);
+            b_.fill(T(0));
         }
 
         Tensor<T, 2> forward(const Tensor<T, 2>& X) override {
             input_ = X;
-            return X.matmul(W_) + b_;
+            if (!sparse_W_) {
+                return X.matmul(W_) + b_;
+            }
+
+            if (X.shape()[1] != in_features_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            const size_t rows = X.shape()[0];
+            Tensor<T, 2> Y(rows, out_features_);
+            for (size_t i = 0; i < rows; ++i)
+                std::copy(b_.cbegin(), b_.cend(), Y.begin() + i * out_features_);
+            sparse_W_->multiply_accumulate(X.data(), rows, Y.data());
+            return Y;
         }
 
         Tensor<T, 2> backward(const Tensor<T, 2>& dY) override {
-            grad_W_ = input_.transpose().matmul(dY);
-            grad_b_ = dY.sum_rows();
-            return dY.matmul(W_.transpose());
+            if (dY.shape()[1] != out_features_ || dY.shape()[0] != input_.shape()[0]) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            Tensor<T, 2> dX(dY.shape()[0], in_features_);
+            backward_planned(input_.data(), nullptr, dY.data(), dX.data(), dY.shape()[0], in_features_);
+            return dX;
+        }
+
+        bool supports_planning() const override { return true; }
+
+        size_t planned_output_features(size_t features) const override {
+            if (features != in_features_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            return out_features_;
+        }
+
+        bool backward_uses_input() const override { return true; }
+
+        void forward_planned(const T* X, T* Y, size_t rows, size_t) override {
+            if (sparse_W_) {
+                for (size_t i = 0; i < rows; ++i)
+                    std::copy(b_.cbegin(), b_.cend(), Y + i * out_features_);
+                sparse_W_->multiply_accumulate(X, rows, Y);
+                return;
+            }
+            utec::algebra::detail::gemm(X, W_.data(), Y, rows, in_features_, out_features_);
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < out_features_; ++j)
+                    Y[i * out_features_ + j] += b_[j];
+        }
+
+        void backward_planned(const T* X, const T*, const T* dY, T* dX, size_t rows, size_t) override {
+            utec::algebra::detail::sum_columns(dY, rows, out_features_, grad_b_.data());
+
+            if (sparse_W_) {
+                sparse_W_->sampled_gradient(X, dY, rows, grad_values_.data());
+                if (dX) sparse_W_->multiply_transposed(dY, rows, dX);
+                return;
+            }
+            utec::algebra::detail::gemm_tn(X, dY, grad_W_.data(), rows, in_features_, out_features_);
+            if (dX) utec::algebra::detail::gemm_nt(dY, W_.data(), dX, rows, out_features_, in_features_);
         }
 
         void update_params(IOptimizer<T>& optimizer) override {
-            optimizer.update(W_, grad_W_);
+            if (sparse_W_) {
+                optimizer.update(sparse_W_->values(), grad_values_);
+            } else {
+                optimizer.update(W_, grad_W_);
+            }
             optimizer.update(b_, grad_b_);
         }
+
+        // Poda por magnitud; si la sparsity resultante supera el umbral la capa pasa a CSR.
+        // En modo disperso el patron de ceros queda fijo durante el entrenamiento.
+        void prune(double target_sparsity) {
+            if (sparse_W_) densify();
+            magnitude_prune(W_, target_sparsity);
+            refresh_storage();
+        }
+
+        void set_sparse_threshold(double threshold) {
+            if (threshold < 0.0 || threshold > 1.0) {
+                throw std::invalid_argument("Sparse threshold must be in [0, 1]");
+            }
+            sparse_threshold_ = threshold;
+            refresh_storage();
+        }
+
+        // false: los pesos quedan densos con cualquier sparsity (los ceros podados se pueden
+        // volver a entrenar); true vuelve a aplicar el umbral
+        void set_sparse_enabled(bool enabled) {
+            sparse_enabled_ = enabled;
+            refresh_storage();
+        }
+
+        void refresh_storage() {
+            if (!sparse_enabled_) {
+                if (sparse_W_) densify();
+                return;
+            }
+            if (sparse_W_) {
+                if (double(sparse_W_->nnz()) <= (1.0 - sparse_threshold_) * double(in_features_ * out_features_))
+                    return;
+                densify();
+            }
+            if (sparsity(W_) < sparse_threshold_) return;
+
+            sparse_W_ = CsrMatrix<T>::from_dense(W_);
+            grad_values_ = Tensor<T, 2>(1, sparse_W_->nnz());
+            W_ = Tensor<T, 2>();
+            grad_W_ = Tensor<T, 2>();
+        }
+
+        const char* name() const override { return "Dense"; }
+        std::unique_ptr<ILayer<T>> clone() const override {
+            auto copy = std::make_unique<Dense<T>>(*this);
+            copy->release_cache();
+            return copy;
+        }
+
+        size_t cache_bytes() const override { return input_.size() * sizeof(T); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override { return rows * features * sizeof(T); }
+        void release_cache() override { input_ = Tensor<T, 2>(); }
+
+        bool is_sparse() const { return sparse_W_.has_value(); }
+
+        size_t nonzero_weights() const {
+            return sparse_W_ ? sparse_W_->nnz() : in_features_ * out_features_;
+        }
+
+        size_t parameter_bytes() const {
+            const size_t weight_bytes = sparse_W_ ? sparse_W_->bytes() : W_.size() * sizeof(T);
+            return weight_bytes + b_.size() * sizeof(T);
+        }
+
+        Tensor<T, 2> weights() const { return sparse_W_ ? sparse_W_->to_dense() : W_; }
+        const Tensor<T, 2>& bias() const { return b_; }
+        // Parametros entrenables y sus gradientes del ultimo backward (valores CSR en modo disperso)
+        Tensor<T, 2>& trainable_weights() { return sparse_W_ ? sparse_W_->values() : W_; }
+        Tensor<T, 2>& trainable_bias() { return b_; }
+        Tensor<T, 2>& weight_gradient() { return sparse_W_ ? grad_values_ : grad_W_; }
+        Tensor<T, 2>& bias_gradient() { return grad_b_; }
+        size_t in_features() const { return in_features_; }
+        size_t out_features() const { return out_features_; }
+
+    private:
+        void densify() {
+            W_ = sparse_W_->to_dense();
+            grad_W_ = Tensor<T, 2>(in_features_, out_features_);
+            sparse_W_.reset();
+            grad_values_ = Tensor<T, 2>();
+        }
     };
 }
 #endif //PROG3_NN_FINAL_PROJECT_V2025_01_DENSE_H 
\ No newline at end of file
@@ -0,0 +1,391 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_DISTRIBUTED_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_DISTRIBUTED_H
+
+// Entrenamiento data-parallel entre procesos. Solo POSIX (sockets TCP o Unix).
+
+#include "neural_network.h"
+#include "nn_training.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace utec::neural_network {
+
+    struct RingOptions {
+        int rank = 0;
+        int world_size = 1;
+        // TCP: direccion IPv4 de cada rango (vacio = todos en 127.0.0.1); escucha en base_port + rank
+        std::vector<std::string> hosts;
+        unsigned short base_port = 29500;
+        // Si no esta vacio se usan sockets Unix en "<unix_path>.<rank>" en lugar de TCP
+        std::string unix_path;
+        int timeout_ms = 60000;
+    };
+
+    // Anillo de procesos: cada rango envia al siguiente y recibe del anterior.
+    // Las operaciones son colectivas: todos los rangos deben llamarlas en el mismo orden.
+    class RingCommunicator {
+        RingOptions options_;
+        int listen_fd_ = -1, next_fd_ = -1, prev_fd_ = -1;
+        std::vector<char> scratch_;
+
+        [[noreturn]] static void fail(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        std::string unix_endpoint(int rank) const {
+            return options_.unix_path + "." + std::to_string(rank);
+        }
+
+        int open_socket() const {
+            const int fd = ::socket(options_.unix_path.empty() ? AF_INET : AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) fail("socket");
+            return fd;
+        }
+
+        // Direccion del rango `rank`; devuelve su longitud
+        socklen_t address(int rank, sockaddr_storage& storage) const {
+            std::memset(&storage, 0, sizeof(storage));
+            if (!options_.unix_path.empty()) {
+                auto* addr = reinterpret_cast<sockaddr_un*>(&storage);
+                const std::string path = unix_endpoint(rank);
+                if (path.size() >= sizeof(addr->sun_path)) {
+                    throw std::invalid_argument("Unix socket path is too long");
+                }
+                addr->sun_family = AF_UNIX;
+                std::memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+                return sizeof(sockaddr_un);
+            }
+            auto* addr = reinterpret_cast<sockaddr_in*>(&storage);
+            addr->sin_family = AF_INET;
+            addr->sin_port = htons(static_cast<unsigned short>(options_.base_port + rank));
+            const std::string host = options_.hosts.empty() ? "127.0.0.1" : options_.hosts[size_t(rank)];
+            if (::inet_pton(AF_INET, host.c_str(), &addr->sin_addr) != 1) {
+                throw std::invalid_argument("Invalid IPv4 address: " + host);
+            }
+            return sizeof(sockaddr_in);
+        }
+
+        void tune(int fd) const {
+            if (options_.unix_path.empty()) {
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+        }
+
+        // Los vecinos pueden arrancar despues: se reintenta hasta timeout_ms
+        int connect_next() const {
+            sockaddr_storage storage;
+            const socklen_t length = address((options_.rank + 1) % options_.world_size, storage);
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.timeout_ms);
+            while (true) {
+                const int fd = open_socket();
+                if (::connect(fd, reinterpret_cast<sockaddr*>(&storage), length) == 0) {
+                    tune(fd);
+                    return fd;
+                }
+                ::close(fd);
+                if (std::chrono::steady_clock::now() > deadline) fail("connect to next rank");
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        }
+
+        int accept_prev() const {
+            pollfd pending{listen_fd_, POLLIN, 0};
+            const int ready = ::poll(&pending, 1, options_.timeout_ms);
+            if (ready == 0) throw std::runtime_error("Timed out waiting for the previous rank");
+            if (ready < 0) fail("poll");
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) fail("accept");
+            tune(fd);
+            return fd;
+        }
+
+        // Envia al siguiente y recibe del anterior a la vez; con sockets bloqueantes dos
+        // vecinos enviando bloques grandes se bloquearian mutuamente
+        void exchange(const char* send, size_t send_bytes, char* recv, size_t recv_bytes) {
+            size_t sent = 0, received = 0;
+            while (sent < send_bytes || received < recv_bytes) {
+                pollfd fds[2];
+                int count = 0, send_slot = -1, recv_slot = -1;
+                if (sent < send_bytes) {
+                    fds[count] = {next_fd_, POLLOUT, 0};
+                    send_slot = count++;
+                }
+                if (received < recv_bytes) {
+                    fds[count] = {prev_fd_, POLLIN, 0};
+                    recv_slot = count++;
+                }
+                const int ready = ::poll(fds, nfds_t(count), options_.timeout_ms);
+                if (ready < 0) {
+                    if (errno == EINTR) continue;
+                    fail("poll");
+                }
+                if (ready == 0) throw std::runtime_error("Timed out waiting for a neighbouring rank");
+
+                if (send_slot >= 0 && fds[send_slot].revents) {
+                    const ssize_t n = ::send(next_fd_, send + sent, send_bytes - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+                    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) fail("send");
+                    if (n > 0) sent += size_t(n);
+                }
+                if (recv_slot >= 0 && fds[recv_slot].revents) {
+                    const ssize_t n = ::recv(prev_fd_, recv + received, recv_bytes - received, MSG_DONTWAIT);
+                    if (n == 0) throw std::runtime_error("Previous rank closed the connection");
+                    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) fail("recv");
+                    if (n > 0) received += size_t(n);
+                }
+            }
+        }
+
+        void close_all() {
+            for (int* fd : {&next_fd_, &prev_fd_, &listen_fd_}) {
+                if (*fd >= 0) ::close(*fd);
+                *fd = -1;
+            }
+            if (!options_.unix_path.empty()) ::unlink(unix_endpoint(options_.rank).c_str());
+        }
+
+    public:
+        explicit RingCommunicator(RingOptions options) : options_(std::move(options)) {
+            if (options_.world_size < 1 || options_.rank < 0 || options_.rank >= options_.world_size) {
+                throw std::invalid_argument("Rank must be in [0, world_size)");
+            }
+            if (!options_.hosts.empty() && options_.hosts.size() != size_t(options_.world_size)) {
+                throw std::invalid_argument("Expected one host per rank");
+            }
+            if (options_.world_size == 1) return;
+
+            try {
+                // Escuchar antes de conectar: connect se completa contra el backlog sin esperar accept
+                listen_fd_ = open_socket();
+                int one = 1;
+                ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                if (!options_.unix_path.empty()) ::unlink(unix_endpoint(options_.rank).c_str());
+                sockaddr_storage storage;
+                const socklen_t length = address(options_.rank, storage);
+                if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&storage), length) < 0) fail("bind");
+                if (::listen(listen_fd_, 1) < 0) fail("listen");
+                next_fd_ = connect_next();
+                prev_fd_ = accept_prev();
+            } catch (...) {
+                close_all();
+                throw;
+            }
+        }
+
+        RingCommunicator(const RingCommunicator&) = delete;
+        RingCommunicator& operator=(const RingCommunicator&) = delete;
+
+        ~RingCommunicator() { close_all(); }
+
+        int rank() const { return options_.rank; }
+        int world_size() const { return options_.world_size; }
+
+        // All-reduce en anillo: reduce-scatter y all-gather en 2 (K - 1) pasos, cada uno con
+        // un bloque de n / K elementos. Todos los rangos terminan con valores identicos.
+        template<typename T>
+        void allreduce_sum(T* data, size_t n) {
+            const size_t world = size_t(options_.world_size), rank = size_t(options_.rank);
+            if (world == 1 || n == 0) return;
+            auto begin = [&](size_t chunk) { return chunk * n / world; };
+            auto length = [&](size_t chunk) { return begin(chunk + 1) - begin(chunk); };
+            scratch_.resize((n / world + 1) * sizeof(T));
+            T* incoming = reinterpret_cast<T*>(scratch_.data());
+
+            for (size_t step = 0; step + 1 < world; ++step) {
+                const size_t send = (rank + world - step) % world;
+                const size_t recv = (rank + world - step - 1) % world;
+                exchange(reinterpret_cast<const char*>(data + begin(send)), length(send) * sizeof(T),
+                         reinterpret_cast<char*>(incoming), length(recv) * sizeof(T));
+                T* target = data + begin(recv);
+                for (size_t i = 0; i < length(recv); ++i) target[i] += incoming[i];
+            }
+            for (size_t step = 0; step + 1 < world; ++step) {
+                const size_t send = (rank + 1 + world - step) % world;
+                const size_t recv = (rank + world - step) % world;
+                exchange(reinterpret_cast<const char*>(data + begin(send)), length(send) * sizeof(T),
+                         reinterpret_cast<char*>(data + begin(recv)), length(recv) * sizeof(T));
+            }
+        }
+
+        // Copia data del rango root a todos los demas pasando por el anillo
+        template<typename T>
+        void broadcast(T* data, size_t n, int root = 0) {
+            const int world = options_.world_size;
+            if (world == 1 || n == 0) return;
+            const int position = (options_.rank - root + world) % world;
+            const size_t bytes = n * sizeof(T);
+            if (position != 0) exchange(nullptr, 0, reinterpret_cast<char*>(data), bytes);
+            if (position != world - 1) exchange(reinterpret_cast<const char*>(data), bytes, nullptr, 0);
+        }
+
+        void barrier() {
+            char token = 0;
+            allreduce_sum(&token, 1);
+        }
+    };
+
+    // Bloque contiguo de filas del rango: todos reciben rows / world_size filas (el resto se
+    // descarta) para que cada proceso haga el mismo numero de pasos por epoca
+    template<typename T>
+    utec::algebra::Tensor<T, 2> shard_rows(const utec::algebra::Tensor<T, 2>& source, int rank, int world_size) {
+        const size_t rows = source.shape()[0] / size_t(world_size);
+        return detail::slice_rows(source, size_t(rank) * rows, rows);
+    }
+
+    // Data parallel: cada proceso entrena su fragmento de datos y en cada paso se promedian los
+    // gradientes de las Dense. Un hilo de comunicacion reduce el gradiente de cada capa mientras
+    // el hilo principal sigue con el backward de las anteriores. Los parametros parten de los
+    // del rango 0 y, con gradientes identicos, se mantienen iguales en todos los procesos.
+    template<typename T>
+    class DataParallel : public IGradientReducer<T> {
+        struct Bucket {
+            Dense<T>* layer;
+            std::vector<T> values;
+        };
+
+        NeuralNetwork<T>& network_;
+        RingCommunicator& comm_;
+        std::vector<Bucket> buckets_;
+        std::unordered_map<const ILayer<T>*, size_t> bucket_of_;
+
+        std::mutex mutex_;
+        std::condition_variable pending_, drained_;
+        std::deque<size_t> queue_;
+        bool busy_ = false, stop_ = false;
+        std::exception_ptr error_;
+        std::thread worker_;
+
+        void reduce(Bucket& bucket) {
+            comm_.allreduce_sum(bucket.values.data(), bucket.values.size());
+            const T scale = T(1) / T(comm_.world_size());
+            auto& gW = bucket.layer->weight_gradient();
+            auto& gb = bucket.layer->bias_gradient();
+            const T* v = bucket.values.data();
+            for (size_t i = 0; i < gW.size(); ++i) gW[i] = v[i] * scale;
+            for (size_t i = 0; i < gb.size(); ++i) gb[i] = v[gW.size() + i] * scale;
+        }
+
+        void run() {
+            std::unique_lock lock(mutex_);
+            while (true) {
+                pending_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                const size_t index = queue_.front();
+                queue_.pop_front();
+                busy_ = true;
+                lock.unlock();
+                try {
+                    if (!error_) reduce(buckets_[index]);
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+                lock.lock();
+                busy_ = false;
+                drained_.notify_all();
+            }
+        }
+
+        // Todos los rangos deben hacer el mismo numero de pasos o el anillo se bloquea
+        void check_batches(size_t batches) {
+            std::vector<double> counts(size_t(comm_.world_size()), 0.0);
+            counts[size_t(comm_.rank())] = double(batches);
+            comm_.allreduce_sum(counts.data(), counts.size());
+            for (double count : counts) {
+                if (count != double(batches)) {
+                    throw std::invalid_argument("Every rank must run the same number of batches per epoch");
+                }
+            }
+        }
+
+    public:
+        DataParallel(NeuralNetwork<T>& network, RingCommunicator& comm) : network_(network), comm_(comm) {
+            for (const auto& layer : network_.layers()) {
+                if (auto* dense = dynamic_cast<Dense<T>*>(layer.get())) {
+                    bucket_of_[dense] = buckets_.size();
+                    buckets_.push_back({dense, std::vector<T>(dense->weight_gradient().size() + dense->bias_gradient().size())});
+                    comm_.broadcast(dense->trainable_weights().data(), dense->trainable_weights().size());
+                    comm_.broadcast(dense->trainable_bias().data(), dense->trainable_bias().size());
+                } else if (!dynamic_cast<const ReLU<T>*>(layer.get()) && !dynamic_cast<const Sigmoid<T>*>(layer.get()) &&
+                           !dynamic_cast<const Softmax<T>*>(layer.get())) {
+                    throw std::invalid_argument(std::string(layer->name()) + " cannot be trained data-parallel");
+                }
+            }
+            worker_ = std::thread([this] { run(); });
+            network_.set_gradient_reducer(this);
+        }
+
+        DataParallel(const DataParallel&) = delete;
+        DataParallel& operator=(const DataParallel&) = delete;
+
+        ~DataParallel() override {
+            network_.set_gradient_reducer(nullptr);
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            pending_.notify_all();
+            worker_.join();
+        }
+
+        void layer_ready(ILayer<T>& layer) override {
+            const auto found = bucket_of_.find(&layer);
+            if (found == bucket_of_.end()) return;
+            Bucket& bucket = buckets_[found->second];
+            const auto& gW = bucket.layer->weight_gradient();
+            const auto& gb = bucket.layer->bias_gradient();
+            // La poda puede pasar la capa a CSR y cambiar el tamano del gradiente
+            bucket.values.resize(gW.size() + gb.size());
+            std::copy(gW.cbegin(), gW.cend(), bucket.values.begin());
+            std::copy(gb.cbegin(), gb.cend(), bucket.values.begin() + std::ptrdiff_t(gW.size()));
+            {
+                std::lock_guard lock(mutex_);
+                queue_.push_back(found->second);
+            }
+            pending_.notify_one();
+        }
+
+        void wait() override {
+            std::unique_lock lock(mutex_);
+            drained_.wait(lock, [&] { return queue_.empty() && !busy_; });
+            if (error_) std::rethrow_exception(error_);
+        }
+
+        // Entrena sobre el fragmento local; devuelve la perdida de cada epoca promediada entre rangos
+        template<template<typename...> class LossType = BCELoss, template<typename...> class OptimizerType = SGD>
+        std::vector<T> train(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                             size_t epochs, size_t batch_size, T lr) {
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
+            check_batches((X.shape()[0] + batch_size - 1) / batch_size);
+            OptimizerType<T> optimizer(lr);
+            std::vector<T> losses;
+            for (size_t epoch = 0; epoch < epochs; ++epoch) {
+                T loss = network_.template train_epoch<LossType>(X, Y, batch_size, optimizer, epoch);
+                comm_.allreduce_sum(&loss, 1);
+                losses.push_back(loss / T(comm_.world_size()));
+            }
+            return losses;
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_DISTRIBUTED_H
@@ -0,0 +1,216 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_ENSEMBLE_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_ENSEMBLE_H
+
+#include "neural_network.h"
+#include "nn_activation.h"
+#include "nn_dense.h"
+#include "nn_interfaces.h"
+#include "tensor.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Inferencia de muchas redes con la misma arquitectura (Dense + ReLU/Sigmoid/Softmax).
+    // Los pesos de cada capa se apilan en un Tensor<T, 3> (modelo x entrada x salida) y cada
+    // capa se evalua con el GEMM por lotes del camino Rank 3 de matrix_product, en paralelo
+    // entre grupos de modelos. Bias y activacion se aplican en la misma pasada sobre la salida.
+    // Los pesos se copian: cambios posteriores en las redes no se reflejan.
+    template<typename T>
+    class NetworkEnsemble {
+        enum class Op { Dense, ReLU, Sigmoid, Softmax };
+
+        struct Stage {
+            Op op;
+            utec::algebra::Tensor<T, 3> W;
+            utec::algebra::Tensor<T, 2> b;
+        };
+
+        static constexpr size_t kGroupBytes = 256 * 1024;
+
+        std::vector<Stage> stages_;
+        size_t models_ = 0, in_features_ = 0, out_features_ = 0, width_ = 0;
+
+        static Op classify(const ILayer<T>* layer) {
+            if (dynamic_cast<const Dense<T>*>(layer)) return Op::Dense;
+            if (dynamic_cast<const ReLU<T>*>(layer)) return Op::ReLU;
+            if (dynamic_cast<const Sigmoid<T>*>(layer)) return Op::Sigmoid;
+            if (dynamic_cast<const Softmax<T>*>(layer)) return Op::Softmax;
+            throw std::invalid_argument(std::string(layer->name()) + " cannot be stacked into an ensemble");
+        }
+
+        static void activate(Op op, T* y, size_t cols) {
+            switch (op) {
+                case Op::ReLU:
+                    for (size_t j = 0; j < cols; ++j) y[j] = std::max(T(0), y[j]);
+                    break;
+                case Op::Sigmoid:
+                    for (size_t j = 0; j < cols; ++j) y[j] = T(1) / (T(1) + std::exp(-y[j]));
+                    break;
+                case Op::Softmax: {
+                    const T max_val = *std::max_element(y, y + cols);
+                    T sum = T(0);
+                    for (size_t j = 0; j < cols; ++j) {
+                        y[j] = std::exp(y[j] - max_val);
+                        sum += y[j];
+                    }
+                    for (size_t j = 0; j < cols; ++j) y[j] /= sum;
+                    break;
+                }
+                case Op::Dense:
+                    break;
+            }
+        }
+
+        // Suma el bias del modelo (si hay) y aplica la activacion sobre `rows` filas por modelo
+        static void epilogue(T* H, size_t models, size_t rows, size_t cols, const T* bias, Op activation) {
+            for (size_t r = 0; r < models * rows; ++r) {
+                T* y = H + r * cols;
+                if (bias) {
+                    const T* b = bias + (r / rows) * cols;
+                    for (size_t j = 0; j < cols; ++j) y[j] = y[j] + b[j];
+                }
+                activate(activation, y, cols);
+            }
+        }
+
+        void stack(const std::vector<const NeuralNetwork<T>*>& networks) {
+            if (networks.empty()) {
+                throw std::invalid_argument("Ensemble needs at least one network");
+            }
+            models_ = networks.size();
+            const auto& reference = networks.front()->layers();
+            if (reference.empty()) {
+                throw std::invalid_argument("Cannot stack an empty network");
+            }
+            for (const auto* network : networks) {
+                if (network->layers().size() != reference.size()) {
+                    throw std::invalid_argument("Networks in an ensemble must share the same architecture");
+                }
+            }
+
+            size_t features = 0;
+            for (size_t i = 0; i < reference.size(); ++i) {
+                Stage stage{classify(reference[i].get()), {}, {}};
+                for (const auto* network : networks) {
+                    if (classify(network->layers()[i].get()) != stage.op) {
+                        throw std::invalid_argument("Networks in an ensemble must share the same architecture");
+                    }
+                }
+
+                if (stage.op == Op::Dense) {
+                    const auto* first = static_cast<const Dense<T>*>(reference[i].get());
+                    const size_t in = first->in_features(), out = first->out_features();
+                    if (i == 0) in_features_ = in;
+                    else if (features != 0 && features != in) {
+                        throw std::invalid_argument("Dense layer inputs do not match the previous layer");
+                    }
+                    stage.W = utec::algebra::Tensor<T, 3>(models_, in, out);
+                    stage.b = utec::algebra::Tensor<T, 2>(models_, out);
+                    for (size_t m = 0; m < models_; ++m) {
+                        const auto* dense = static_cast<const Dense<T>*>(networks[m]->layers()[i].get());
+                        if (dense->in_features() != in || dense->out_features() != out) {
+                            throw std::invalid_argument("Networks in an ensemble must share the same architecture");
+                        }
+                        const auto W = dense->weights();
+                        std::copy(W.cbegin(), W.cend(), stage.W.data() + m * in * out);
+                        std::copy(dense->bias().cbegin(), dense->bias().cend(), stage.b.data() + m * out);
+                    }
+                    features = out;
+                    width_ = std::max(width_, out);
+                }
+                stages_.push_back(std::move(stage));
+            }
+            if (stages_.front().op != Op::Dense) {
+                throw std::invalid_argument("Ensemble networks must start with a Dense layer");
+            }
+            out_features_ = features;
+        }
+
+        // Modelos por grupo: las activaciones de un grupo caben en cache y cada hilo lleva su
+        // grupo por todas las capas antes de pasar al siguiente
+        size_t group_size(size_t rows) const {
+            const size_t per_model = std::max<size_t>(rows * width_ * sizeof(T), 1);
+            return std::clamp<size_t>(kGroupBytes / per_model, 1, models_);
+        }
+
+        // input: modelos x filas x in_features, o filas x in_features compartido (input_stride == 0)
+        utec::algebra::Tensor<T, 3> run(const T* input, size_t input_stride, size_t rows) const {
+            utec::algebra::Tensor<T, 3> result(models_, rows, out_features_);
+            const size_t group = group_size(rows);
+            const size_t groups = (models_ + group - 1) / group;
+
+            #pragma omp parallel for schedule(dynamic)
+            for (size_t g = 0; g < groups; ++g) {
+                const size_t first = g * group;
+                const size_t count = std::min(group, models_ - first);
+                std::vector<T> ping(count * rows * width_), pong(count * rows * width_);
+
+                const T* current = input + first * input_stride;
+                T* output = nullptr;
+                size_t stride = input_stride, cols = in_features_;
+                for (size_t s = 0; s < stages_.size(); ++s) {
+                    const Stage& stage = stages_[s];
+                    if (stage.op != Op::Dense) {
+                        // La primera etapa es Dense: output ya apunta a un buffer propio
+                        epilogue(output, count, rows, cols, nullptr, stage.op);
+                        continue;
+                    }
+                    // Un GEMM por lotes para todos los modelos del grupo (la entrada compartida
+                    // usa stride 0 y no se replica)
+                    const size_t out = stage.W.shape()[2];
+                    T* next = output == ping.data() ? pong.data() : ping.data();
+                    utec::algebra::detail::batched_gemm(current, stage.W.data() + first * cols * out, next,
+                                                        count, rows, cols, out, stride, cols * out);
+                    // La activacion siguiente se fusiona con la suma del bias
+                    const bool fuse = s + 1 < stages_.size() && stages_[s + 1].op != Op::Dense;
+                    epilogue(next, count, rows, out, stage.b.data() + first * out,
+                             fuse ? stages_[s + 1].op : Op::Dense);
+                    if (fuse) ++s;
+                    current = output = next;
+                    stride = rows * out;
+                    cols = out;
+                }
+                std::copy(output, output + count * rows * cols, result.data() + first * rows * cols);
+            }
+            return result;
+        }
+
+    public:
+        explicit NetworkEnsemble(const std::vector<const NeuralNetwork<T>*>& networks) {
+            stack(networks);
+        }
+
+        explicit NetworkEnsemble(const std::vector<NeuralNetwork<T>>& networks) {
+            std::vector<const NeuralNetwork<T>*> pointers;
+            for (const auto& network : networks) pointers.push_back(&network);
+            stack(pointers);
+        }
+
+        size_t models() const { return models_; }
+        size_t input_features() const { return in_features_; }
+        size_t output_features() const { return out_features_; }
+
+        // Todos los modelos sobre el mismo batch: resultado modelos x filas x salidas
+        utec::algebra::Tensor<T, 3> predict(const utec::algebra::Tensor<T, 2>& X) const {
+            if (X.shape()[1] != in_features_) {
+                throw std::invalid_argument("Input features do not match the ensemble");
+            }
+            return run(X.data(), 0, X.shape()[0]);
+        }
+
+        // Un batch por modelo: X es modelos x filas x in_features
+        utec::algebra::Tensor<T, 3> predict(const utec::algebra::Tensor<T, 3>& X) const {
+            if (X.shape()[0] != models_ || X.shape()[2] != in_features_) {
+                throw std::invalid_argument("Input shape does not match the ensemble");
+            }
+            return run(X.data(), X.shape()[1] * X.shape()[2], X.shape()[1]);
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_ENSEMBLE_H
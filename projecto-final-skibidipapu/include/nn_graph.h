@@ -0,0 +1,260 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_GRAPH_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_GRAPH_H
+
+#include "neural_network.h"
+#include "nn_interfaces.h"
+#include "nn_loss.h"
+#include "nn_optimizer.h"
+#include "tensor.h"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Buffer del plan: vive entre los pasos first_use y last_use (inclusive)
+    struct BufferLifetime {
+        std::string name;
+        size_t rows = 0, cols = 0;
+        size_t first_use = 0, last_use = 0;
+        size_t offset = 0;
+
+        size_t elements() const { return rows * cols; }
+    };
+
+    // Asignacion greedy por tamano: los buffers grandes se ubican primero, cada uno en el
+    // menor offset libre entre los buffers ya ubicados cuya vida se solapa con la suya.
+    // Devuelve el tamano del slab en elementos.
+    inline size_t plan_memory(std::vector<BufferLifetime>& buffers, size_t alignment = 1) {
+        auto padded = [alignment](size_t elements) {
+            return (elements + alignment - 1) / alignment * alignment;
+        };
+
+        std::vector<size_t> order(buffers.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&buffers](size_t a, size_t b) {
+            return buffers[a].elements() > buffers[b].elements();
+        });
+
+        std::vector<size_t> placed;
+        std::vector<std::pair<size_t, size_t>> taken;
+        size_t total = 0;
+        for (size_t index : order) {
+            auto& buffer = buffers[index];
+            const size_t size = padded(buffer.elements());
+
+            taken.clear();
+            for (size_t other : placed) {
+                const auto& o = buffers[other];
+                if (o.first_use <= buffer.last_use && buffer.first_use <= o.last_use)
+                    taken.emplace_back(o.offset, o.offset + padded(o.elements()));
+            }
+            std::sort(taken.begin(), taken.end());
+
+            size_t offset = 0;
+            for (const auto& [begin, end] : taken) {
+                if (offset + size <= begin) break;
+                offset = std::max(offset, end);
+            }
+            buffer.offset = offset;
+            total = std::max(total, offset + size);
+            placed.push_back(index);
+        }
+        return total;
+    }
+
+    // Traza la cadena de capas de una red para un batch fijo y ubica todas las activaciones
+    // y gradientes en un unico slab preasignado, reutilizando memoria segun su vida util.
+    // Los pasos de entrenamiento no reservan memoria (salvo el estado perezoso del optimizador).
+    // Las capas siguen perteneciendo a la red: el grafo solo las referencia.
+    template<typename T, template<typename...> class LossType = BCELoss>
+    class StaticGraph {
+        static constexpr size_t kAlignBytes = 64;
+        static constexpr size_t kAlignment = kAlignBytes % sizeof(T) == 0 ? kAlignBytes / sizeof(T) : 1;
+
+        std::vector<ILayer<T>*> layers_;
+        std::vector<size_t> features_;
+        std::vector<BufferLifetime> buffers_;
+        std::vector<size_t> activation_, gradient_;
+        size_t target_ = 0;
+        size_t batch_size_;
+        size_t slab_elements_ = 0;
+        std::vector<T> slab_;
+        T* base_ = nullptr;
+
+        static constexpr size_t kNone = static_cast<size_t>(-1);
+
+        size_t add_buffer(std::string name, size_t cols, size_t first_use, size_t last_use) {
+            buffers_.push_back(BufferLifetime{std::move(name), batch_size_, cols, first_use, last_use, 0});
+            return buffers_.size() - 1;
+        }
+
+        T* buffer(size_t index) { return base_ + buffers_[index].offset; }
+
+        // Paso 0: copia de entrada; capa i hacia adelante: i + 1; perdida: L + 1;
+        // capa i hacia atras: 2L + 1 - i
+        size_t backward_step(size_t i) const { return 2 * layers_.size() + 1 - i; }
+
+        void copy_rows(const utec::algebra::Tensor<T, 2>& source, size_t start, size_t rows, T* destination) {
+            const size_t cols = source.shape()[1];
+            std::copy(source.data() + start * cols, source.data() + (start + rows) * cols, destination);
+        }
+
+        void check_batch(const utec::algebra::Tensor<T, 2>& X, size_t start, size_t rows) const {
+            if (X.shape()[1] != features_.front()) {
+                throw std::invalid_argument("Input features do not match the planned graph");
+            }
+            if (rows == 0 || rows > batch_size_ || start + rows > X.shape()[0]) {
+                throw std::invalid_argument("Batch rows exceed the planned batch size");
+            }
+        }
+
+        void run_forward(size_t rows) {
+            for (size_t i = 0; i < layers_.size(); ++i)
+                layers_[i]->forward_planned(buffer(activation_[i]), buffer(activation_[i + 1]), rows, features_[i]);
+        }
+
+    public:
+        StaticGraph(const NeuralNetwork<T>& network, size_t batch_size, size_t input_features)
+                : batch_size_(batch_size) {
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
+            for (const auto& layer : network.layers()) {
+                if (!layer->supports_planning()) {
+                    throw std::invalid_argument(std::string(layer->name()) + " does not support planned execution");
+                }
+                layers_.push_back(layer.get());
+            }
+            if (layers_.empty()) {
+                throw std::invalid_argument("Cannot plan an empty network");
+            }
+
+            const size_t L = layers_.size();
+            features_.push_back(input_features);
+            for (auto* layer : layers_)
+                features_.push_back(layer->planned_output_features(features_.back()));
+
+            for (size_t i = 0; i <= L; ++i) {
+                size_t last = i < L ? i + 1 : L + 1;
+                if (i < L && layers_[i]->backward_uses_input()) last = std::max(last, backward_step(i));
+                if (i > 0 && layers_[i - 1]->backward_uses_output()) last = std::max(last, backward_step(i - 1));
+                activation_.push_back(add_buffer(i == 0 ? "x" : "a" + std::to_string(i), features_[i],
+                                                 i == 0 ? 0 : i, last));
+            }
+            target_ = add_buffer("target", features_[L], 0, L + 1);
+
+            gradient_.assign(L + 1, kNone);
+            gradient_[L] = add_buffer("grad a" + std::to_string(L), features_[L], L + 1, backward_step(L - 1));
+            for (size_t i = L - 1; i >= 1; --i)
+                gradient_[i] = add_buffer("grad a" + std::to_string(i), features_[i], backward_step(i), backward_step(i - 1));
+
+            slab_elements_ = plan_memory(buffers_, kAlignment);
+            slab_.assign(slab_elements_ + kAlignment, T(0));
+            const auto address = reinterpret_cast<std::uintptr_t>(slab_.data());
+            base_ = slab_.data() + ((kAlignBytes - address % kAlignBytes) % kAlignBytes) / sizeof(T);
+        }
+
+        // Un paso de entrenamiento sobre las filas [start, start + rows); devuelve la perdida
+        T train_step(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                     size_t start, size_t rows, IOptimizer<T>& optimizer) {
+            check_batch(X, start, rows);
+            if (Y.shape()[1] != features_.back() || Y.shape()[0] < start + rows) {
+                throw std::invalid_argument("Target shape does not match the planned graph");
+            }
+            const size_t L = layers_.size();
+            copy_rows(X, start, rows, buffer(activation_[0]));
+            copy_rows(Y, start, rows, buffer(target_));
+
+            run_forward(rows);
+            const T loss = LossType<T>::compute(buffer(activation_[L]), buffer(target_), rows, features_[L],
+                                                buffer(gradient_[L]));
+
+            for (size_t i = L; i-- > 0;) {
+                layers_[i]->backward_planned(buffer(activation_[i]), buffer(activation_[i + 1]),
+                                             buffer(gradient_[i + 1]), i > 0 ? buffer(gradient_[i]) : nullptr,
+                                             rows, features_[i]);
+            }
+            for (auto* layer : layers_)
+                layer->update_params(optimizer);
+            return loss;
+        }
+
+        // Recorre X en batches del tamano planificado; devuelve la perdida promedio
+        T train_epoch(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                      IOptimizer<T>& optimizer) {
+            const size_t num_samples = X.shape()[0];
+            const size_t num_batches = (num_samples + batch_size_ - 1) / batch_size_;
+            T total = 0;
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                const size_t start = batch * batch_size_;
+                total += train_step(X, Y, start, std::min(batch_size_, num_samples - start), optimizer);
+            }
+            return total / num_batches;
+        }
+
+        template<template<typename...> class OptimizerType = SGD>
+        T train(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                const size_t epochs, T lr) {
+            OptimizerType<T> optimizer(lr);
+            T loss = 0;
+            for (size_t epoch = 0; epoch < epochs; ++epoch)
+                loss = train_epoch(X, Y, optimizer);
+            return loss;
+        }
+
+        // La salida vive en el slab y es valida hasta la siguiente llamada
+        const T* forward(const utec::algebra::Tensor<T, 2>& X, size_t start, size_t rows) {
+            check_batch(X, start, rows);
+            copy_rows(X, start, rows, buffer(activation_[0]));
+            run_forward(rows);
+            return buffer(activation_.back());
+        }
+
+        utec::algebra::Tensor<T, 2> predict(const utec::algebra::Tensor<T, 2>& X) {
+            utec::algebra::Tensor<T, 2> output(X.shape()[0], features_.back());
+            const size_t cols = features_.back();
+            for (size_t start = 0; start < X.shape()[0]; start += batch_size_) {
+                const size_t rows = std::min(batch_size_, X.shape()[0] - start);
+                const T* result = forward(X, start, rows);
+                std::copy(result, result + rows * cols, output.data() + start * cols);
+            }
+            return output;
+        }
+
+        size_t batch_size() const { return batch_size_; }
+        size_t input_features() const { return features_.front(); }
+        size_t output_features() const { return features_.back(); }
+        const std::vector<BufferLifetime>& buffers() const { return buffers_; }
+
+        // Memoria del slab frente a reservar cada buffer por separado
+        size_t peak_bytes() const { return slab_elements_ * sizeof(T); }
+        size_t unplanned_bytes() const {
+            size_t total = 0;
+            for (const auto& buffer : buffers_) total += buffer.elements() * sizeof(T);
+            return total;
+        }
+
+        void print_plan(std::ostream& os) const {
+            os << "Plan de memoria (batch " << batch_size_ << ", " << layers_.size() << " capas)\n";
+            os << std::left << std::setw(12) << "  buffer" << std::right << std::setw(12) << "forma"
+               << std::setw(12) << "offset" << std::setw(12) << "vida" << '\n';
+            for (const auto& buffer : buffers_) {
+                os << std::left << std::setw(12) << "  " + buffer.name << std::right
+                   << std::setw(12) << std::to_string(buffer.rows) + "x" + std::to_string(buffer.cols)
+                   << std::setw(12) << buffer.offset
+                   << std::setw(12) << std::to_string(buffer.first_use) + "-" + std::to_string(buffer.last_use) << '\n';
+            }
+            os << "  slab: " << peak_bytes() << " bytes (sin plan: " << unplanned_bytes() << " bytes)\n";
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_GRAPH_H
@@ -2,6 +2,9 @@
 #define PROG3_NN_FINAL_PROJECT_V2025_01_LAYER_H
 
 #include "tensor.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace utec::neural_network {
 
@@ -13,6 +16,35 @@ namespace utec::neural_network {
         virtual utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& input) = 0;
         virtual utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>& gradient) = 0;
         virtual void update_params(IOptimizer<T>&) {}
+        virtual const char* name() const { return "Layer"; }
+
+        // Activaciones que la capa guarda para backward (gradient checkpointing). cache_bytes_for
+        // da lo que guardaria forward con una entrada rows x features, sin ejecutarlo.
+        virtual size_t cache_bytes() const { return 0; }
+        virtual size_t cache_bytes_for(size_t /*rows*/, size_t /*features*/) const { return 0; }
+        virtual void release_cache() {}
+
+        // Ejecucion planificada (nn_graph.h): la capa escribe en buffers preasignados
+        // en lugar de devolver tensores nuevos. X y dX tienen `features` columnas.
+        virtual bool supports_planning() const { return false; }
+        virtual size_t planned_output_features(size_t features) const { return features; }
+        virtual bool backward_uses_input() const { return false; }
+        virtual bool backward_uses_output() const { return false; }
+        virtual void forward_planned(const T* /*X*/, T* /*Y*/, size_t /*rows*/, size_t /*features*/) {
+            throw std::logic_error(std::string(name()) + " does not support planned execution");
+        }
+        // dX puede ser nulo (primera capa): solo se calculan los gradientes de parametros
+        virtual void backward_planned(const T* /*X*/, const T* /*Y*/, const T* /*dY*/, T* /*dX*/,
+                                      size_t /*rows*/, size_t /*features*/) {
+            throw std::logic_error(std::string(name()) + " does not support planned execution");
+        }
+
+        // Copia independiente de parametros y configuracion (sin activaciones guardadas);
+        // la usa la validacion en segundo plano de nn_training.h
+        virtual std::unique_ptr<ILayer<T>> clone() const {
+            throw std::logic_error(std::string(name()) + " does not support cloning");
+        }
+
         virtual ~ILayer() = default;
     };
 
@@ -21,14 +53,37 @@ namespace utec::neural_network {
     public:
         virtual T loss() const = 0;
         virtual utec::algebra::Tensor<T, Rank> loss_gradient() const = 0;
+        // Perdida y gradiente en una sola pasada; grad se reutiliza si ya tiene la forma correcta
+        virtual T compute(utec::algebra::Tensor<T, Rank>& grad) const {
+            grad = loss_gradient();
+            return loss();
+        }
         virtual ~ILoss() = default;
     };
 
+    // Promedia gradientes entre procesos (nn_distributed.h). NeuralNetwork llama layer_ready
+    // apenas termina el backward de una capa y wait antes de aplicar el optimizador, de modo
+    // que la comunicacion se solapa con el backward de las capas anteriores.
+    template<typename T>
+    class IGradientReducer {
+    public:
+        virtual void layer_ready(ILayer<T>& layer) = 0;
+        virtual void wait() = 0;
+        virtual ~IGradientReducer() = default;
+    };
+
     template<typename T>
     class IOptimizer {
     public:
         virtual void update(utec::algebra::Tensor<T, 2>& params, const utec::algebra::Tensor<T, 2>& grads) = 0;
         virtual void step() {}
+        // Para schedules de learning rate (callbacks de nn_training.h)
+        virtual T learning_rate() const {
+            throw std::logic_error("Optimizer does not expose a learning rate");
+        }
+        virtual void set_learning_rate(T) {
+            throw std::logic_error("Optimizer does not expose a learning rate");
+        }
         virtual ~IOptimizer() = default;
     };
 
@@ -3,97 +3,252 @@
 
 #include "nn_interfaces.h"
 #include "tensor.h"
+#include "tensor_reduce.h"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 namespace utec::neural_network {
 
+    // Las perdidas referencian predicciones y objetivos sin copiarlos: ambos tensores deben
+    // vivir mientras se use la perdida (por eso se borran los constructores con temporales).
+    // compute(grad) devuelve la perdida y escribe el gradiente en una sola pasada; la version
+    // estatica sobre punteros la usa la ejecucion planificada de nn_graph.h.
+
+    namespace detail {
+        template<typename T>
+        void check_same_shape(const utec::algebra::Tensor<T, 2>& y_pred, const utec::algebra::Tensor<T, 2>& y_true) {
+            if (y_pred.shape() != y_true.shape()) {
+                throw std::invalid_argument("Prediction and target shapes do not match");
+            }
+        }
+
+        // Solo reserva si el buffer del llamador no tiene ya la forma correcta
+        template<typename T>
+        void fit_gradient(utec::algebra::Tensor<T, 2>& grad, const utec::algebra::Tensor<T, 2>& like) {
+            if (grad.shape() != like.shape()) grad = utec::algebra::Tensor<T, 2>(like.shape());
+        }
+    }
+
     template<typename T>
     class MSELoss final : public ILoss<T, 2> {
-        utec::algebra::Tensor<T, 2> y_pred_, y_true_;
+        const utec::algebra::Tensor<T, 2>& y_pred_;
+        const utec::algebra::Tensor<T, 2>& y_true_;
     public:
         MSELoss(const utec::algebra::Tensor<T, 2> &y_pred, const utec::algebra::Tensor<T, 2> &y_true)
-                : y_pred_{y_pred}, y_true_{y_true} {}
+                : y_pred_{y_pred}, y_true_{y_true} {
+            detail::check_same_shape(y_pred, y_true);
+        }
+        MSELoss(utec::algebra::Tensor<T, 2>&&, const utec::algebra::Tensor<T, 2>&) = delete;
+        MSELoss(const utec::algebra::Tensor<T, 2>&, utec::algebra::Tensor<T, 2>&&) = delete;
+        MSELoss(utec::algebra::Tensor<T, 2>&&, utec::algebra::Tensor<T, 2>&&) = delete;
+
+        static T compute(const T* y_pred, const T* y_true, size_t rows, size_t cols, T* grad) {
+            const size_t n = rows * cols;
+            const T sum = utec::algebra::parallel_sum<T>(n, [=](size_t i) {
+                const T diff = y_pred[i] - y_true[i];
+                if (grad) grad[i] = 2 * diff / n;
+                return diff * diff;
+            });
+            return sum / n;
+        }
 
         T loss() const override {
-            T sum = 0;
-            for (size_t i = 0; i < y_pred_.size(); ++i) {
-                T diff = y_pred_[i] - y_true_[i];
-                sum += diff * diff;
-            }
-            return sum / y_pred_.size();
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], nullptr);
         }
 
         utec::algebra::Tensor<T, 2> loss_gradient() const override {
-            utec::algebra::Tensor<T, 2> grad = y_pred_;
-            for (size_t i = 0; i < grad.size(); ++i)
-                grad[i] = 2 * (y_pred_[i] - y_true_[i]) / grad.size();
+            utec::algebra::Tensor<T, 2> grad(y_pred_.shape());
+            compute(grad);
             return grad;
         }
+
+        T compute(utec::algebra::Tensor<T, 2>& grad) const override {
+            detail::fit_gradient(grad, y_pred_);
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], grad.data());
+        }
     };
 
     template<typename T>
     class BCELoss final : public ILoss<T, 2> {
-        utec::algebra::Tensor<T, 2> y_pred_, y_true_;
+        const utec::algebra::Tensor<T, 2>& y_pred_;
+        const utec::algebra::Tensor<T, 2>& y_true_;
     public:
         BCELoss(const  utec::algebra::Tensor<T, 2> &y_pred, const  utec::algebra::Tensor<T, 2> &y_true)
-                : y_pred_{y_pred}, y_true_{y_true} {}
+                : y_pred_{y_pred}, y_true_{y_true} {
+            detail::check_same_shape(y_pred, y_true);
+        }
+        BCELoss(utec::algebra::Tensor<T, 2>&&, const utec::algebra::Tensor<T, 2>&) = delete;
+        BCELoss(const utec::algebra::Tensor<T, 2>&, utec::algebra::Tensor<T, 2>&&) = delete;
+        BCELoss(utec::algebra::Tensor<T, 2>&&, utec::algebra::Tensor<T, 2>&&) = delete;
+
+        static T compute(const T* y_pred, const T* y_true, size_t rows, size_t cols, T* grad) {
+            const size_t n = rows * cols;
+            const T sum = utec::algebra::parallel_sum<T>(n, [=](size_t i) {
+                const T yp = std::min(std::max(y_pred[i], T(1e-7)), T(1 - 1e-7));
+                if (grad) grad[i] = (yp - y_true[i]) / (yp * (1 - yp) * n);
+                return -y_true[i] * std::log(yp) - (1 - y_true[i]) * std::log(1 - yp);
+            });
+            return sum / n;
+        }
 
         T loss() const override {
-            T sum = 0;
-            for (size_t i = 0; i < y_pred_.size(); ++i) {
-                T yp = std::min(std::max(y_pred_[i], T(1e-7)), T(1 - 1e-7));
-                sum += -y_true_[i] * std::log(yp) - (1 - y_true_[i]) * std::log(1 - yp);
-            }
-            return sum / y_pred_.size();
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], nullptr);
         }
 
         utec::algebra::Tensor<T, 2> loss_gradient() const override {
-            utec::algebra::Tensor<T, 2> grad = y_pred_;
-            for (size_t i = 0; i < grad.size(); ++i) {
-                T yp = std::min(std::max(y_pred_[i], T(1e-7)), T(1 - 1e-7));
-                grad[i] = (yp - y_true_[i]) / (yp * (1 - yp) * grad.size());
-            }
+            utec::algebra::Tensor<T, 2> grad(y_pred_.shape());
+            compute(grad);
             return grad;
         }
+
+        T compute(utec::algebra::Tensor<T, 2>& grad) const override {
+            detail::fit_gradient(grad, y_pred_);
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], grad.data());
+        }
     };
 
+    // Gradiente respecto a las probabilidades; compuesto con Softmax::backward da (p - y) / N.
+    // Para entrenar clasificadores conviene SoftmaxCrossEntropyLoss sobre los logits.
     template<typename T>
     class CrossEntropyLoss final : public ILoss<T, 2> {
-        utec::algebra::Tensor<T, 2> y_pred_, y_true_;
+        const utec::algebra::Tensor<T, 2>& y_pred_;
+        const utec::algebra::Tensor<T, 2>& y_true_;
     public:
         CrossEntropyLoss(const utec::algebra::Tensor<T, 2>& y_pred, const utec::algebra::Tensor<T, 2>& y_true)
-                : y_pred_{y_pred}, y_true_{y_true} {}
+                : y_pred_{y_pred}, y_true_{y_true} {
+            detail::check_same_shape(y_pred, y_true);
+        }
+        CrossEntropyLoss(utec::algebra::Tensor<T, 2>&&, const utec::algebra::Tensor<T, 2>&) = delete;
+        CrossEntropyLoss(const utec::algebra::Tensor<T, 2>&, utec::algebra::Tensor<T, 2>&&) = delete;
+        CrossEntropyLoss(utec::algebra::Tensor<T, 2>&&, utec::algebra::Tensor<T, 2>&&) = delete;
+
+        static T compute(const T* y_pred, const T* y_true, size_t num_samples, size_t num_classes, T* grad) {
+            const T sum = utec::algebra::parallel_sum<T>(num_samples * num_classes, [=](size_t idx) {
+                const T yp = std::min(std::max(y_pred[idx], T(1e-15)), T(1 - 1e-15));
+                if (grad) grad[idx] = -y_true[idx] / (yp * num_samples);
+                return y_true[idx] > 0 ? -y_true[idx] * std::log(yp) : T(0);
+            });
+            return sum / num_samples;
+        }
 
         T loss() const override {
-            T sum = 0;
-            size_t num_samples = y_pred_.shape()[0];
-            size_t num_classes = y_pred_.shape()[1];
-            
-            for (size_t i = 0; i < num_samples; ++i) {
-                for (size_t j = 0; j < num_classes; ++j) {
-                    if (y_true_(i, j) > 0) {
-                        T yp = std::min(std::max(y_pred_(i, j), T(1e-15)), T(1 - 1e-15));
-                        sum += -y_true_(i, j) * std::log(yp);
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], nullptr);
+        }
+
+        utec::algebra::Tensor<T, 2> loss_gradient() const override {
+            utec::algebra::Tensor<T, 2> grad(y_pred_.shape());
+            compute(grad);
+            return grad;
+        }
+
+        T compute(utec::algebra::Tensor<T, 2>& grad) const override {
+            detail::fit_gradient(grad, y_pred_);
+            return compute(y_pred_.data(), y_true_.data(), y_pred_.shape()[0], y_pred_.shape()[1], grad.data());
+        }
+    };
+
+    // Softmax + entropia cruzada sobre logits crudos: log-sum-exp estable y gradiente
+    // (p - y) / N en una sola pasada por fila, en paralelo entre muestras.
+    // y_true puede ser one-hot (N x C) o etiquetas dispersas (N x 1 con el indice de clase).
+    template<typename T>
+    class SoftmaxCrossEntropyLoss final : public ILoss<T, 2> {
+        const utec::algebra::Tensor<T, 2>& logits_;
+        const utec::algebra::Tensor<T, 2>& y_true_;
+        bool sparse_;
+
+        T evaluate(T* grad) const {
+            const size_t rows = logits_.shape()[0], classes = logits_.shape()[1];
+            return sparse_ ? compute_sparse(logits_.data(), y_true_.data(), rows, classes, grad)
+                           : compute(logits_.data(), y_true_.data(), rows, classes, grad);
+        }
+
+        template<bool Sparse>
+        static T fused(const T* logits, const T* targets, size_t rows, size_t classes, T* grad) {
+            const T inv_rows = T(1) / T(rows);
+            const T sum = utec::algebra::parallel_sum<T>(rows, [=](size_t i) {
+                const T* z = logits + i * classes;
+                T max_val = z[0];
+                for (size_t j = 1; j < classes; ++j)
+                    max_val = std::max(max_val, z[j]);
+
+                // Las exponenciales se guardan en grad y se normalizan despues
+                T* g = grad ? grad + i * classes : nullptr;
+                T exp_sum = 0;
+                for (size_t j = 0; j < classes; ++j) {
+                    const T e = std::exp(z[j] - max_val);
+                    if (g) g[j] = e;
+                    exp_sum += e;
+                }
+                const T log_sum_exp = max_val + std::log(exp_sum);
+                const T scale = inv_rows / exp_sum;
+
+                if constexpr (Sparse) {
+                    const size_t label = static_cast<size_t>(targets[i]);
+                    if (g) {
+                        for (size_t j = 0; j < classes; ++j)
+                            g[j] *= scale;
+                        g[label] -= inv_rows;
                     }
+                    return log_sum_exp - z[label];
+                } else {
+                    const T* y = targets + i * classes;
+                    T row_loss = 0;
+                    for (size_t j = 0; j < classes; ++j) {
+                        if (y[j] != T(0)) row_loss += y[j] * (log_sum_exp - z[j]);
+                        if (g) g[j] = g[j] * scale - y[j] * inv_rows;
+                    }
+                    return row_loss;
                 }
-            }
-            return sum / num_samples;
+            });
+            return sum * inv_rows;
         }
 
-        utec::algebra::Tensor<T, 2> loss_gradient() const override {
-            utec::algebra::Tensor<T, 2> grad = y_pred_;
-            size_t num_samples = y_pred_.shape()[0];
-            size_t num_classes = y_pred_.shape()[1];
-            
-            for (size_t i = 0; i < num_samples; ++i) {
-                for (size_t j = 0; j < num_classes; ++j) {
-                    T yp = std::min(std::max(y_pred_(i, j), T(1e-15)), T(1 - 1e-15));
-                    grad(i, j) = (yp - y_true_(i, j)) / num_samples;
+    public:
+        SoftmaxCrossEntropyLoss(const utec::algebra::Tensor<T, 2>& logits, const utec::algebra::Tensor<T, 2>& y_true)
+                : logits_{logits}, y_true_{y_true},
+                  sparse_(y_true.shape()[1] == 1 && logits.shape()[1] > 1) {
+            if (y_true.shape()[0] != logits.shape()[0] || (!sparse_ && y_true.shape()[1] != logits.shape()[1])) {
+                throw std::invalid_argument("Targets must be one-hot (N x C) or class labels (N x 1)");
+            }
+            if (sparse_) {
+                for (size_t i = 0; i < y_true_.size(); ++i) {
+                    const T label = y_true_[i];
+                    if (!(label >= T(0) && label < T(logits.shape()[1])) || label != std::floor(label)) {
+                        throw std::out_of_range("Class label out of range");
+                    }
                 }
             }
+        }
+        SoftmaxCrossEntropyLoss(utec::algebra::Tensor<T, 2>&&, const utec::algebra::Tensor<T, 2>&) = delete;
+        SoftmaxCrossEntropyLoss(const utec::algebra::Tensor<T, 2>&, utec::algebra::Tensor<T, 2>&&) = delete;
+        SoftmaxCrossEntropyLoss(utec::algebra::Tensor<T, 2>&&, utec::algebra::Tensor<T, 2>&&) = delete;
+
+        // Objetivos one-hot (misma forma que los logits)
+        static T compute(const T* logits, const T* y_true, size_t rows, size_t classes, T* grad) {
+            return fused<false>(logits, y_true, rows, classes, grad);
+        }
+
+        // labels[i] es el indice de clase de la fila i
+        static T compute_sparse(const T* logits, const T* labels, size_t rows, size_t classes, T* grad) {
+            return fused<true>(logits, labels, rows, classes, grad);
+        }
+
+        T loss() const override {
+            return evaluate(nullptr);
+        }
+
+        utec::algebra::Tensor<T, 2> loss_gradient() const override {
+            utec::algebra::Tensor<T, 2> grad(logits_.shape());
+            evaluate(grad.data());
             return grad;
         }
+
+        T compute(utec::algebra::Tensor<T, 2>& grad) const override {
+            detail::fit_gradient(grad, logits_);
+            return evaluate(grad.data());
+        }
     };
 }
 
-#endif //PROG3_NN_FINAL_PROJECT_V2025_01_LOSS_H 
\ No newline at end of file
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_LOSS_H
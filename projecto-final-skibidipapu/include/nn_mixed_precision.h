@@ -0,0 +1,180 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_MIXED_PRECISION_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_MIXED_PRECISION_H
+
+#include "nn_interfaces.h"
+#include "nn_dense.h"
+#include "bfloat16.h"
+#include "tensor.h"
+#include <functional>
+#include <type_traits>
+
+namespace utec::neural_network {
+
+    // Capa densa con parametros y activaciones guardadas en Storage (float o bfloat16)
+    // y acumulacion en T. Los gradientes y la interfaz con el optimizador estan en T.
+    template<typename T, typename Storage = T>
+    class MixedDense : public ILayer<T> {
+        static_assert(std::is_floating_point_v<T>, "MixedDense accumulates in a floating point type");
+
+        Tensor<Storage, 2> W_, b_;
+        Tensor<Storage, 2> input_;
+        Tensor<T, 2> grad_W_, grad_b_;
+        Tensor<T, 2> W_work_, b_work_;
+
+        static constexpr bool same_storage = std::is_same_v<T, Storage>;
+
+    public:
+        using InitFunction = std::function<void(Tensor<T, 2>&)>;
+
+        MixedDense(size_t in_features, size_t out_features,
+                   InitFunction init_w, InitFunction init_b)
+                : W_(in_features, out_features),
+                  b_(1, out_features),
+                  grad_W_(in_features, out_features),
+                  grad_b_(1, out_features) {
+            if constexpr (same_storage) {
+                init_w(W_);
+                init_b(b_);
+            } else {
+                W_work_ = Tensor<T, 2>(in_features, out_features);
+                b_work_ = Tensor<T, 2>(1, out_features);
+                init_w(W_work_);
+                init_b(b_work_);
+                utec::algebra::convert(W_work_.data(), W_.data(), W_.size());
+                utec::algebra::convert(b_work_.data(), b_.data(), b_.size());
+            }
+        }
+
+        MixedDense(size_t in_features, size_t out_features)
+                : MixedDense(in_features, out_features,
+                             xavier_normal_init<T>,
+                             [](Tensor<T, 2>& tensor) { tensor.fill(T(0)); }) {}
+
+        Tensor<T, 2> forward(const Tensor<T, 2>& X) override {
+            const size_t rows = X.shape()[0];
+            const size_t in = W_.shape()[0];
+            const size_t out = W_.shape()[1];
+            if (X.shape()[1] != in) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+
+            input_ = Tensor<Storage, 2>(rows, in);
+            utec::algebra::convert(X.data(), input_.data(), X.size());
+
+            Tensor<T, 2> Y(rows, out);
+            const T* x = X.data();
+            const Storage* w = W_.data();
+            const Storage* b = b_.data();
+            T* y = Y.data();
+
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows; ++i) {
+                T* y_row = y + i * out;
+                for (size_t j = 0; j < out; ++j)
+                    y_row[j] = static_cast<T>(b[j]);
+                for (size_t k = 0; k < in; ++k) {
+                    const T a = static_cast<T>(static_cast<Storage>(x[i * in + k]));
+                    const Storage* w_row = w + k * out;
+                    for (size_t j = 0; j < out; ++j)
+                        y_row[j] += a * static_cast<T>(w_row[j]);
+                }
+            }
+            return Y;
+        }
+
+        Tensor<T, 2> backward(const Tensor<T, 2>& dY) override {
+            const size_t rows = dY.shape()[0];
+            const size_t in = W_.shape()[0];
+            const size_t out = W_.shape()[1];
+
+            const Storage* x = input_.data();
+            const Storage* w = W_.data();
+            const T* dy = dY.data();
+            T* gw = grad_W_.data();
+            T* gb = grad_b_.data();
+
+            #pragma omp parallel for
+            for (size_t k = 0; k < in; ++k) {
+                T* gw_row = gw + k * out;
+                for (size_t j = 0; j < out; ++j)
+                    gw_row[j] = T(0);
+                for (size_t i = 0; i < rows; ++i) {
+                    const T a = static_cast<T>(x[i * in + k]);
+                    const T* dy_row = dy + i * out;
+                    for (size_t j = 0; j < out; ++j)
+                        gw_row[j] += a * dy_row[j];
+                }
+            }
+
+            utec::algebra::detail::sum_columns(dy, rows, out, gb);
+
+            Tensor<T, 2> dX(rows, in);
+            T* dx = dX.data();
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows; ++i) {
+                const T* dy_row = dy + i * out;
+                for (size_t k = 0; k < in; ++k) {
+                    const Storage* w_row = w + k * out;
+                    T sum = T(0);
+                    for (size_t j = 0; j < out; ++j)
+                        sum += dy_row[j] * static_cast<T>(w_row[j]);
+                    dx[i * in + k] = sum;
+                }
+            }
+            return dX;
+        }
+
+        // Sin copia maestra en el optimizador, cada paso se redondea a Storage.
+        // Usar MasterWeights para acumular las actualizaciones en fp64.
+        void update_params(IOptimizer<T>& optimizer) override {
+            if constexpr (same_storage) {
+                optimizer.update(W_, grad_W_);
+                optimizer.update(b_, grad_b_);
+            } else {
+                utec::algebra::convert(W_.data(), W_work_.data(), W_.size());
+                utec::algebra::convert(b_.data(), b_work_.data(), b_.size());
+                optimizer.update(W_work_, grad_W_);
+                optimizer.update(b_work_, grad_b_);
+                utec::algebra::convert(W_work_.data(), W_.data(), W_.size());
+                utec::algebra::convert(b_work_.data(), b_.data(), b_.size());
+            }
+        }
+
+        const char* name() const override { return "MixedDense"; }
+        std::unique_ptr<ILayer<T>> clone() const override {
+            auto copy = std::make_unique<MixedDense<T, Storage>>(*this);
+            copy->release_cache();
+            return copy;
+        }
+
+        const Tensor<Storage, 2>& weights() const { return W_; }
+        const Tensor<Storage, 2>& bias() const { return b_; }
+
+        size_t parameter_bytes() const {
+            return (W_.size() + b_.size()) * sizeof(Storage);
+        }
+
+        size_t activation_bytes() const {
+            return input_.size() * sizeof(Storage);
+        }
+
+        size_t cache_bytes() const override { return activation_bytes(); }
+        size_t cache_bytes_for(size_t rows, size_t features) const override {
+            return rows * features * sizeof(Storage);
+        }
+
+        size_t planned_output_features(size_t features) const override {
+            if (features != W_.shape()[0]) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            return W_.shape()[1];
+        }
+        void release_cache() override { input_ = Tensor<Storage, 2>(); }
+    };
+
+    template<typename T>
+    using BF16Dense = MixedDense<T, utec::algebra::bfloat16>;
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_MIXED_PRECISION_H
@@ -0,0 +1,228 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_ONLINE_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_ONLINE_H
+
+#include "neural_network.h"
+#include "nn_graph.h"
+#include "nn_loss.h"
+#include "nn_optimizer.h"
+#include "tensor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utec::neural_network {
+
+    struct LatencySummary {
+        size_t count = 0;
+        double p50_us = 0, p90_us = 0, p99_us = 0, max_us = 0;
+    };
+
+    // Ventana circular con las ultimas `capacity` duraciones. record no bloquea (un fetch_add
+    // y un store), asi medir no agrega contencion entre los hilos que llaman a predict.
+    class LatencyRecorder {
+        std::vector<std::atomic<std::uint64_t>> window_;
+        std::atomic<std::uint64_t> recorded_{0};
+
+    public:
+        explicit LatencyRecorder(size_t capacity = 4096) : window_(std::max<size_t>(capacity, 1)) {}
+
+        void record(std::chrono::steady_clock::duration elapsed) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            const std::uint64_t slot = recorded_.fetch_add(1, std::memory_order_relaxed);
+            window_[slot % window_.size()].store(std::uint64_t(std::max<std::int64_t>(ns, 0)),
+                                                 std::memory_order_relaxed);
+        }
+
+        std::uint64_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+
+        // Percentiles por rango mas cercano sobre la ventana actual
+        LatencySummary summary() const {
+            const size_t count = size_t(std::min<std::uint64_t>(recorded(), window_.size()));
+            LatencySummary result;
+            result.count = count;
+            if (count == 0) return result;
+            std::vector<std::uint64_t> samples(count);
+            for (size_t i = 0; i < count; ++i) samples[i] = window_[i].load(std::memory_order_relaxed);
+            std::sort(samples.begin(), samples.end());
+            auto percentile = [&](double p) {
+                const size_t rank = size_t(std::ceil(p * double(count)));
+                return double(samples[std::clamp<size_t>(rank, 1, count) - 1]) * 1e-3;
+            };
+            result.p50_us = percentile(0.50);
+            result.p90_us = percentile(0.90);
+            result.p99_us = percentile(0.99);
+            result.max_us = double(samples.back()) * 1e-3;
+            return result;
+        }
+    };
+
+    struct OnlineOptions {
+        // Filas del plan de StaticGraph: un batch mas grande se parte en varios pasos
+        size_t max_batch = 64;
+        // Publicar los pesos cada tantas llamadas a partial_fit (publish() fuerza una publicacion).
+        // Publicar clona la red: reserva una copia de todos los parametros y cuesta mucho mas
+        // que un paso chico, asi que por defecto se amortiza entre varias actualizaciones.
+        size_t publish_every = 16;
+        size_t latency_window = 4096;
+    };
+
+    // Aprendizaje incremental: partial_fit aplica un paso del optimizador por cada batch que
+    // llega, sobre el slab preasignado de StaticGraph, y predict atiende en paralelo desde la
+    // ultima version publicada. Las versiones son inmutables y se publican al estilo RCU: el
+    // escritor clona la red y reemplaza el shared_ptr de forma atomica; cada lector toma una
+    // referencia y la version vieja se libera cuando termina el ultimo lector que la usaba.
+    // Los pasos no reservan memoria; la llamada a partial_fit que publica si (el clon y el
+    // bloque del shared_ptr), y su costo se mide aparte en publish_latency(). Los lectores solo usan
+    // forward_planned, que lee parametros y escribe en buffers del llamador, de modo que
+    // varios hilos pueden evaluar la misma version a la vez.
+    template<typename T, template<typename...> class LossType = BCELoss,
+             template<typename...> class OptimizerType = SGD>
+    class OnlineLearner {
+        struct Version {
+            std::uint64_t id = 0;
+            NeuralNetwork<T> network;
+        };
+
+        NeuralNetwork<T> network_;
+        std::vector<size_t> features_;
+        StaticGraph<T, LossType> graph_;
+        OptimizerType<T> optimizer_;
+        OnlineOptions options_;
+
+        mutable std::mutex write_mutex_;
+        std::uint64_t updates_ = 0, samples_ = 0, pending_ = 0;
+        std::shared_ptr<const Version> current_;
+
+        LatencyRecorder update_latency_, predict_latency_, publish_latency_;
+
+        static std::vector<size_t> plan_features(const NeuralNetwork<T>& network, size_t input_features) {
+            std::vector<size_t> features{input_features};
+            for (const auto& layer : network.layers()) {
+                if (!layer->supports_planning()) {
+                    throw std::invalid_argument(std::string(layer->name()) + " does not support planned execution");
+                }
+                features.push_back(layer->planned_output_features(features.back()));
+            }
+            return features;
+        }
+
+        // Llamar con write_mutex_ tomado
+        void publish_locked() {
+            const auto start = std::chrono::steady_clock::now();
+            auto version = std::make_shared<Version>();
+            version->id = updates_;
+            version->network = network_.snapshot();
+            std::atomic_store(&current_, std::shared_ptr<const Version>(std::move(version)));
+            pending_ = 0;
+            publish_latency_.record(std::chrono::steady_clock::now() - start);
+        }
+
+    public:
+        OnlineLearner(NeuralNetwork<T> network, size_t input_features, T learning_rate, OnlineOptions options = {})
+                : network_(std::move(network)),
+                  features_(plan_features(network_, input_features)),
+                  graph_(network_, options.max_batch, input_features),
+                  optimizer_(learning_rate),
+                  options_(options),
+                  update_latency_(options.latency_window),
+                  predict_latency_(options.latency_window),
+                  publish_latency_(options.latency_window) {
+            if (options_.publish_every == 0) {
+                throw std::invalid_argument("publish_every must be positive");
+            }
+            std::lock_guard lock(write_mutex_);
+            publish_locked();
+        }
+
+        OnlineLearner(const OnlineLearner&) = delete;
+        OnlineLearner& operator=(const OnlineLearner&) = delete;
+
+        // Un paso del optimizador por cada bloque de hasta max_batch filas; devuelve la perdida
+        // media del batch. Los escritores se serializan entre si, nunca con los lectores.
+        // update_latency() mide solo los pasos: la publicacion que toque se registra aparte.
+        T partial_fit(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y) {
+            const size_t rows = X.shape()[0];
+            if (rows == 0 || Y.shape()[0] != rows) {
+                throw std::invalid_argument("partial_fit needs a non-empty batch with one target per row");
+            }
+            std::lock_guard lock(write_mutex_);
+            const auto start = std::chrono::steady_clock::now();
+            T total = 0;
+            for (size_t first = 0; first < rows; first += options_.max_batch) {
+                const size_t count = std::min(options_.max_batch, rows - first);
+                total += graph_.train_step(X, Y, first, count, optimizer_) * T(count);
+            }
+            ++updates_;
+            samples_ += rows;
+            update_latency_.record(std::chrono::steady_clock::now() - start);
+            if (++pending_ >= options_.publish_every) publish_locked();
+            return total / T(rows);
+        }
+
+        // Hace visibles para predict los pesos actuales aunque no toque publicar
+        void publish() {
+            std::lock_guard lock(write_mutex_);
+            if (pending_ > 0) publish_locked();
+        }
+
+        // Seguro desde cualquier numero de hilos, en paralelo con partial_fit
+        utec::algebra::Tensor<T, 2> predict(const utec::algebra::Tensor<T, 2>& X) {
+            if (X.shape()[1] != features_.front()) {
+                throw std::invalid_argument("Input features do not match the online model");
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const std::shared_ptr<const Version> version = std::atomic_load(&current_);
+            const size_t rows = X.shape()[0];
+            const size_t width = *std::max_element(features_.begin(), features_.end());
+
+            // Buffers por hilo: tras el primer batch de un tamano dado, predict solo reserva la salida
+            thread_local std::vector<T> ping, pong;
+            if (ping.size() < rows * width) {
+                ping.resize(rows * width);
+                pong.resize(rows * width);
+            }
+            const T* input = X.data();
+            T* output = ping.data();
+            const auto& layers = version->network.layers();
+            for (size_t i = 0; i < layers.size(); ++i) {
+                layers[i]->forward_planned(input, output, rows, features_[i]);
+                input = output;
+                output = output == ping.data() ? pong.data() : ping.data();
+            }
+
+            utec::algebra::Tensor<T, 2> result(rows, features_.back());
+            std::copy(input, input + result.size(), result.data());
+            predict_latency_.record(std::chrono::steady_clock::now() - start);
+            return result;
+        }
+
+        // Numero de partial_fit incluidos en la version que ven los lectores
+        std::uint64_t version() const { return std::atomic_load(&current_)->id; }
+        std::uint64_t updates() const {
+            std::lock_guard lock(write_mutex_);
+            return updates_;
+        }
+        std::uint64_t samples_seen() const {
+            std::lock_guard lock(write_mutex_);
+            return samples_;
+        }
+
+        // Copia independiente de la version publicada (para checkpoints o evaluacion)
+        NeuralNetwork<T> published_network() const { return std::atomic_load(&current_)->network.snapshot(); }
+
+        LatencySummary update_latency() const { return update_latency_.summary(); }
+        LatencySummary predict_latency() const { return predict_latency_.summary(); }
+        // Incluye la version inicial que publica el constructor
+        LatencySummary publish_latency() const { return publish_latency_.summary(); }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_ONLINE_H
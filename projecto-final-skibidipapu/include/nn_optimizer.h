@@ -4,6 +4,8 @@
 #include "nn_interfaces.h"
 #include "tensor.h"
 #include <cmath>
+#include <memory>
+#include <unordered_map>
 
 using utec::algebra::Tensor;
 
@@ -15,6 +17,9 @@ namespace utec::neural_network {
     public:
         explicit SGD(T lr = 0.01) : lr_{lr} {}
 
+        T learning_rate() const override { return lr_; }
+        void set_learning_rate(T lr) override { lr_ = lr; }
+
         void update(Tensor<T, 2>& params, const Tensor<T, 2>& grads) override {
             for (size_t i = 0; i < params.size(); ++i)
                 params[i] -= lr_ * grads[i];
@@ -31,6 +36,9 @@ namespace utec::neural_network {
         Adam(T lr = 0.001, T beta1 = 0.9, T beta2 = 0.999, T eps = 1e-8)
                 : lr_(lr), beta1_(beta1), beta2_(beta2), eps_(eps) {}
 
+        T learning_rate() const override { return lr_; }
+        void set_learning_rate(T lr) override { lr_ = lr; }
+
         void update(Tensor<T, 2>& param, const Tensor<T, 2>& grad) override {
             if (m_.empty()) {
                 m_ = Tensor<T, 2>(param.shape()[0], param.shape()[1]);
@@ -52,5 +60,56 @@ namespace utec::neural_network {
         }
     };
 
+    // Mantiene una copia maestra en fp64 de cada parametro y aplica Inner<double> sobre ella.
+    // Los parametros de la capa solo reciben la version redondeada de la copia maestra.
+    template<typename T, template<typename...> class Inner = SGD>
+    class MasterWeights final : public IOptimizer<T> {
+        struct Slot {
+            Tensor<double, 2> master, grad;
+            Inner<double> optimizer;
+        };
+
+        double lr_;
+        std::unordered_map<const Tensor<T, 2>*, std::unique_ptr<Slot>> slots_;
+
+    public:
+        explicit MasterWeights(T lr = 0.01) : lr_{static_cast<double>(lr)} {}
+
+        T learning_rate() const override { return static_cast<T>(lr_); }
+        void set_learning_rate(T lr) override {
+            lr_ = static_cast<double>(lr);
+            for (auto& entry : slots_)
+                entry.second->optimizer.set_learning_rate(lr_);
+        }
+
+        void update(Tensor<T, 2>& params, const Tensor<T, 2>& grads) override {
+            auto& slot = slots_[&params];
+            if (!slot) {
+                slot = std::make_unique<Slot>(Slot{Tensor<double, 2>(params.shape()),
+                                                   Tensor<double, 2>(params.shape()),
+                                                   Inner<double>(lr_)});
+                for (size_t i = 0; i < params.size(); ++i)
+                    slot->master[i] = static_cast<double>(params[i]);
+            }
+
+            for (size_t i = 0; i < grads.size(); ++i)
+                slot->grad[i] = static_cast<double>(grads[i]);
+            slot->optimizer.update(slot->master, slot->grad);
+            for (size_t i = 0; i < params.size(); ++i)
+                params[i] = static_cast<T>(slot->master[i]);
+        }
+
+        void step() override {
+            for (auto& entry : slots_)
+                entry.second->optimizer.step();
+        }
+    };
+
+    template<typename T>
+    using MasterSGD = MasterWeights<T, SGD>;
+
+    template<typename T>
+    using MasterAdam = MasterWeights<T, Adam>;
+
 }
 #endif //PROG3_NN_FINAL_PROJECT_V2025_01_OPTIMIZER_H 
\ No newline at end of file
@@ -0,0 +1,278 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_PROFILER_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_PROFILER_H
+
+#include "nn_interfaces.h"
+#include "nn_dense.h"
+#include "tensor.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Con UTEC_NN_PROFILING sin definir, NeuralNetwork descarta toda la instrumentacion
+    // en tiempo de compilacion (if constexpr), sin costo en el camino caliente. El macro
+    // cambia el cuerpo de NeuralNetwork: debe valer lo mismo en todo el programa, por eso se
+    // define desde CMake (opcion UTEC_ENABLE_PROFILING o target_compile_definitions) y no
+    // dentro de un archivo fuente.
+#ifdef UTEC_NN_PROFILING
+    inline constexpr bool kProfilingEnabled = true;
+#else
+    inline constexpr bool kProfilingEnabled = false;
+#endif
+
+    enum class ProfilePhase : size_t { Forward = 0, Backward = 1, Update = 2, Loss = 3 };
+    constexpr size_t kProfilePhases = 4;
+
+    inline const char* phase_name(ProfilePhase phase) {
+        switch (phase) {
+            case ProfilePhase::Forward: return "forward";
+            case ProfilePhase::Backward: return "backward";
+            case ProfilePhase::Update: return "update";
+            default: return "loss";
+        }
+    }
+
+    struct PhaseTotals {
+        double seconds = 0;
+        size_t bytes = 0;
+        double flops = 0;
+        size_t calls = 0;
+    };
+
+    struct LayerTotals {
+        std::string name;
+        std::array<PhaseTotals, kProfilePhases> phases{};
+    };
+
+    struct EpochProfile {
+        size_t epoch = 0;
+        size_t steps = 0;
+        std::vector<LayerTotals> layers;
+    };
+
+    template<typename T>
+    class Profiler {
+        using clock = std::chrono::steady_clock;
+
+        struct TraceEvent {
+            size_t names;  // indice en name_sets_: nombres de las capas cuando se grabo
+            size_t layer;
+            ProfilePhase phase;
+            size_t epoch, step;
+            int64_t start_ns, duration_ns;
+            size_t bytes;
+            double flops;
+        };
+
+        static constexpr size_t kLossSlot = static_cast<size_t>(-1);
+        static constexpr size_t kPredictEpoch = static_cast<size_t>(-1);
+
+        clock::time_point origin_ = clock::now();
+        std::vector<std::string> layer_names_;
+        // Cada cambio de capas (quantize, prune, add_layer) agrega un juego de nombres; los
+        // eventos ya grabados conservan el suyo
+        std::vector<std::vector<std::string>> name_sets_{{}};
+        std::vector<EpochProfile> epochs_;
+        EpochProfile predict_;
+        std::vector<TraceEvent> trace_;
+        size_t max_trace_events_;
+        size_t dropped_events_ = 0;
+        size_t epoch_ = kPredictEpoch;
+        size_t step_ = 0;
+
+        static double dense_flops(const ILayer<T>* layer, ProfilePhase phase, size_t rows) {
+            auto* dense = dynamic_cast<const Dense<T>*>(layer);
+            if (!dense) return 0.0;
+            const double macs = double(rows) * double(dense->nonzero_weights());
+            const double bias = double(rows) * double(dense->out_features());
+            switch (phase) {
+                case ProfilePhase::Forward: return 2.0 * macs + bias;
+                case ProfilePhase::Backward: return 4.0 * macs + bias;
+                case ProfilePhase::Update: return 2.0 * (double(dense->nonzero_weights()) + dense->out_features());
+                default: return 0.0;
+            }
+        }
+
+        EpochProfile& current() {
+            return epoch_ == kPredictEpoch ? predict_ : epochs_.back();
+        }
+
+        LayerTotals& slot(EpochProfile& profile, size_t layer) {
+            const size_t index = layer == kLossSlot ? layer_names_.size() : layer;
+            if (profile.layers.size() != layer_names_.size() + 1) {
+                profile.layers.resize(layer_names_.size() + 1);
+                for (size_t i = 0; i < layer_names_.size(); ++i)
+                    profile.layers[i].name = layer_names_[i];
+                profile.layers.back().name = "loss";
+            }
+            return profile.layers[index];
+        }
+
+        // Solo lo que reserva el hilo que ejecuta la capa
+        static size_t allocated_bytes() {
+            return utec::algebra::detail::allocated_bytes();
+        }
+
+    public:
+        class Scope {
+            Profiler* profiler_;
+            const ILayer<T>* layer_;
+            size_t index_;
+            ProfilePhase phase_;
+            size_t rows_;
+            clock::time_point start_;
+            size_t bytes_start_;
+
+        public:
+            Scope(Profiler* profiler, const ILayer<T>* layer, size_t index, ProfilePhase phase, size_t rows)
+                    : profiler_(profiler), layer_(layer), index_(index), phase_(phase), rows_(rows),
+                      start_(clock::now()), bytes_start_(allocated_bytes()) {}
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            ~Scope() {
+                const auto end = clock::now();
+                profiler_->record(layer_, index_, phase_, rows_, start_, end, allocated_bytes() - bytes_start_);
+            }
+        };
+
+        explicit Profiler(size_t max_trace_events = 200000) : max_trace_events_(max_trace_events) {}
+
+        static constexpr bool enabled() { return kProfilingEnabled; }
+
+        void set_layers(const std::vector<std::string>& names) {
+            if (names != layer_names_) {
+                layer_names_ = names;
+                name_sets_.push_back(names);
+                predict_.layers.clear();
+            }
+        }
+
+        void begin_epoch(size_t epoch) {
+            epoch_ = epoch;
+            step_ = 0;
+            epochs_.push_back(EpochProfile{epoch, 0, {}});
+        }
+
+        void end_step() {
+            ++step_;
+            ++current().steps;
+        }
+
+        void end_epoch() {
+            epoch_ = kPredictEpoch;
+        }
+
+        Scope scope(const ILayer<T>* layer, size_t index, ProfilePhase phase, size_t rows) {
+            return Scope(this, layer, index, phase, rows);
+        }
+
+        Scope loss_scope(size_t rows) {
+            return Scope(this, nullptr, kLossSlot, ProfilePhase::Loss, rows);
+        }
+
+        void record(const ILayer<T>* layer, size_t index, ProfilePhase phase, size_t rows,
+                    clock::time_point start, clock::time_point end, size_t bytes) {
+            const double flops = dense_flops(layer, phase, rows);
+            auto& totals = slot(current(), index).phases[static_cast<size_t>(phase)];
+            totals.seconds += std::chrono::duration<double>(end - start).count();
+            totals.bytes += bytes;
+            totals.flops += flops;
+            ++totals.calls;
+
+            if (trace_.size() >= max_trace_events_) {
+                ++dropped_events_;
+                return;
+            }
+            trace_.push_back(TraceEvent{
+                name_sets_.size() - 1, index, phase, epoch_, step_,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                bytes, flops});
+        }
+
+        const std::vector<EpochProfile>& epochs() const { return epochs_; }
+        const EpochProfile& predict_profile() const { return predict_; }
+        size_t dropped_events() const { return dropped_events_; }
+
+        void clear() {
+            epochs_.clear();
+            predict_ = EpochProfile{};
+            trace_.clear();
+            name_sets_.assign(1, layer_names_);
+            dropped_events_ = 0;
+            origin_ = clock::now();
+        }
+
+        static void print_profile(std::ostream& os, const EpochProfile& profile, const std::string& title) {
+            os << title << " (" << profile.steps << " pasos)\n";
+            os << std::left << std::setw(18) << "  capa" << std::right
+               << std::setw(12) << "fwd ms" << std::setw(12) << "bwd ms" << std::setw(12) << "upd ms"
+               << std::setw(12) << "MB alloc" << std::setw(12) << "GFLOP/s" << '\n';
+            os << std::fixed;
+            for (size_t i = 0; i < profile.layers.size(); ++i) {
+                const auto& layer = profile.layers[i];
+                double seconds = 0, flops = 0;
+                size_t bytes = 0, calls = 0;
+                for (const auto& phase : layer.phases) {
+                    seconds += phase.seconds;
+                    flops += phase.flops;
+                    bytes += phase.bytes;
+                    calls += phase.calls;
+                }
+                if (calls == 0) continue;
+                std::string name = "  " + (i + 1 < profile.layers.size() ? std::to_string(i) + " " : "") + layer.name;
+                os << std::left << std::setw(18) << name << std::right << std::setprecision(3)
+                   << std::setw(12) << layer.phases[0].seconds * 1e3
+                   << std::setw(12) << (layer.phases[1].seconds + layer.phases[3].seconds) * 1e3
+                   << std::setw(12) << layer.phases[2].seconds * 1e3
+                   << std::setw(12) << double(bytes) / (1024.0 * 1024.0)
+                   << std::setw(12) << (seconds > 0 ? flops / seconds * 1e-9 : 0.0) << '\n';
+            }
+            os.unsetf(std::ios::fixed);
+        }
+
+        void write_epoch_report(std::ostream& os) const {
+            for (const auto& profile : epochs_)
+                print_profile(os, profile, "Epoca " + std::to_string(profile.epoch + 1));
+            if (predict_.steps > 0)
+                print_profile(os, predict_, "Predict");
+        }
+
+        // Formato Trace Event de Chrome (chrome://tracing, Perfetto)
+        void write_chrome_trace(std::ostream& os) const {
+            os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            bool first = true;
+            for (const auto& event : trace_) {
+                const bool is_loss = event.layer == kLossSlot;
+                const bool is_predict = event.epoch == kPredictEpoch;
+                os << (first ? "\n" : ",\n");
+                first = false;
+                os << "{\"name\":\"";
+                if (is_loss) os << "loss";
+                else {
+                    const auto& names = name_sets_[event.names];
+                    os << event.layer << ' ' << (event.layer < names.size() ? names[event.layer] : "?") << ' '
+                       << phase_name(event.phase);
+                }
+                os << "\",\"cat\":\"" << (is_predict ? "predict" : phase_name(event.phase))
+                   << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (is_predict ? 2 : 1)
+                   << ",\"ts\":" << double(event.start_ns) / 1e3
+                   << ",\"dur\":" << double(event.duration_ns) / 1e3
+                   << ",\"args\":{\"step\":" << event.step;
+                if (!is_predict) os << ",\"epoch\":" << event.epoch + 1;
+                os << ",\"bytes\":" << event.bytes << ",\"flops\":" << event.flops << "}}";
+            }
+            os << "\n]}\n";
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_PROFILER_H
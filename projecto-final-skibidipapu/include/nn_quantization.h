@@ -0,0 +1,235 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
+
+#include "nn_interfaces.h"
+#include "nn_dense.h"
+#include "tensor.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace utec::neural_network {
+
+    // Las activaciones se cuantizan a [0, 127] (7 bits) para que maddubs no sature:
+    // 127 * 127 * 2 < 32767. Asi todos los kernels dan exactamente el mismo int32.
+    constexpr int32_t kActivationQMax = 127;
+    constexpr int32_t kWeightQMax = 127;
+    constexpr size_t kQuantBlock = 32;
+
+    struct QuantizationParams {
+        float scale = 1.0f;
+        int32_t zero_point = 0;
+    };
+
+    template<typename T>
+    class ActivationObserver {
+        T min_ = std::numeric_limits<T>::max();
+        T max_ = std::numeric_limits<T>::lowest();
+
+    public:
+        void observe(const utec::algebra::Tensor<T, 2>& X) {
+            for (size_t i = 0; i < X.size(); ++i) {
+                min_ = std::min(min_, X[i]);
+                max_ = std::max(max_, X[i]);
+            }
+        }
+
+        QuantizationParams params() const {
+            if (min_ > max_) return {};
+            const double lo = std::min(double(min_), 0.0);
+            const double hi = std::max(double(max_), 0.0);
+            QuantizationParams result;
+            result.scale = hi > lo ? float((hi - lo) / kActivationQMax) : 1.0f;
+            result.zero_point = std::clamp(int32_t(std::lround(-lo / result.scale)), int32_t(0), kActivationQMax);
+            return result;
+        }
+    };
+
+    namespace detail {
+
+#if defined(__AVX2__)
+        inline int32_t hsum_epi32(__m256i v) {
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+            return _mm_cvtsi128_si32(sum);
+        }
+
+        inline __m256i dot_block_u8s8(__m256i acc, __m256i x, __m256i w) {
+#if defined(__AVXVNNI__)
+            return _mm256_dpbusd_avx_epi32(acc, x, w);
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+            return _mm256_dpbusd_epi32(acc, x, w);
+#else
+            const __m256i pairs = _mm256_maddubs_epi16(x, w);
+            return _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+#endif
+        }
+#endif
+
+        inline const char* int8_kernel_name() {
+#if defined(__AVXVNNI__)
+            return "AVX-VNNI";
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+            return "AVX512-VNNI";
+#elif defined(__AVX2__)
+            return "AVX2 maddubs";
+#else
+            return "scalar";
+#endif
+        }
+
+        // acc[i * n + j] = sum_k x[i * k_padded + k] * w[j * k_padded + k]
+        // x: m x k_padded (uint8), w: n x k_padded (int8, transpuesta), k_padded multiplo de kQuantBlock
+        inline void gemm_u8s8(const uint8_t* x, const int8_t* w, int32_t* acc,
+                              size_t m, size_t n, size_t k_padded) {
+            #pragma omp parallel for
+            for (size_t i = 0; i < m; ++i) {
+                const uint8_t* x_row = x + i * k_padded;
+                int32_t* acc_row = acc + i * n;
+#if defined(__AVX2__)
+                size_t j = 0;
+                for (; j + 4 <= n; j += 4) {
+                    const int8_t* w0 = w + j * k_padded;
+                    __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+                    for (size_t k = 0; k < k_padded; k += kQuantBlock) {
+                        const __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x_row + k));
+                        a0 = dot_block_u8s8(a0, xv, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w0 + k)));
+                        a1 = dot_block_u8s8(a1, xv, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w0 + k_padded + k)));
+                        a2 = dot_block_u8s8(a2, xv, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w0 + 2 * k_padded + k)));
+                        a3 = dot_block_u8s8(a3, xv, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w0 + 3 * k_padded + k)));
+                    }
+                    acc_row[j] = hsum_epi32(a0);
+                    acc_row[j + 1] = hsum_epi32(a1);
+                    acc_row[j + 2] = hsum_epi32(a2);
+                    acc_row[j + 3] = hsum_epi32(a3);
+                }
+                for (; j < n; ++j) {
+                    const int8_t* w_row = w + j * k_padded;
+                    __m256i a = _mm256_setzero_si256();
+                    for (size_t k = 0; k < k_padded; k += kQuantBlock) {
+                        a = dot_block_u8s8(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x_row + k)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w_row + k)));
+                    }
+                    acc_row[j] = hsum_epi32(a);
+                }
+#else
+                for (size_t j = 0; j < n; ++j) {
+                    const int8_t* w_row = w + j * k_padded;
+                    int32_t sum = 0;
+                    for (size_t k = 0; k < k_padded; ++k)
+                        sum += int32_t(x_row[k]) * int32_t(w_row[k]);
+                    acc_row[j] = sum;
+                }
+#endif
+            }
+        }
+
+    }
+
+    // Capa densa solo para inferencia con pesos int8 (escala por canal de salida),
+    // GEMM int8 x int8 -> int32 y epilogo de recuantizacion + bias + ReLU opcional.
+    template<typename T>
+    class QuantizedDense final : public ILayer<T> {
+        size_t in_, out_, k_padded_;
+        std::vector<int8_t> weights_;
+        std::vector<float> weight_scales_;
+        std::vector<int32_t> weight_sums_;
+        std::vector<float> bias_;
+        QuantizationParams input_params_;
+        bool fuse_relu_;
+
+    public:
+        QuantizedDense(const Dense<T>& layer, QuantizationParams input_params, bool fuse_relu = false)
+                : in_(layer.in_features()),
+                  out_(layer.out_features()),
+                  k_padded_((layer.in_features() + kQuantBlock - 1) / kQuantBlock * kQuantBlock),
+                  weights_(layer.out_features() * k_padded_, 0),
+                  weight_scales_(layer.out_features()),
+                  weight_sums_(layer.out_features(), 0),
+                  bias_(layer.out_features()),
+                  input_params_(input_params),
+                  fuse_relu_(fuse_relu) {
+            const auto& W = layer.weights();
+            for (size_t j = 0; j < out_; ++j) {
+                double max_abs = 0.0;
+                for (size_t k = 0; k < in_; ++k)
+                    max_abs = std::max(max_abs, std::fabs(double(W[k * out_ + j])));
+                const double scale = max_abs > 0.0 ? max_abs / kWeightQMax : 1.0;
+                weight_scales_[j] = float(scale);
+                for (size_t k = 0; k < in_; ++k) {
+                    const int32_t q = std::clamp(int32_t(std::lround(double(W[k * out_ + j]) / scale)),
+                                                 -kWeightQMax, kWeightQMax);
+                    weights_[j * k_padded_ + k] = int8_t(q);
+                    weight_sums_[j] += q;
+                }
+                bias_[j] = float(layer.bias()[j]);
+            }
+        }
+
+        utec::algebra::Tensor<T, 2> forward(const utec::algebra::Tensor<T, 2>& X) override {
+            const size_t rows = X.shape()[0];
+            if (X.shape()[1] != in_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+
+            // El relleno usa el zero point y los pesos de relleno son nulos, asi que no aporta
+            std::vector<uint8_t> xq(rows * k_padded_, uint8_t(input_params_.zero_point));
+            const float inv_scale = 1.0f / input_params_.scale;
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t k = 0; k < in_; ++k) {
+                    const int32_t q = int32_t(std::nearbyint(float(X[i * in_ + k]) * inv_scale)) + input_params_.zero_point;
+                    xq[i * k_padded_ + k] = uint8_t(std::clamp(q, int32_t(0), kActivationQMax));
+                }
+            }
+
+            std::vector<int32_t> acc(rows * out_);
+            detail::gemm_u8s8(xq.data(), weights_.data(), acc.data(), rows, out_, k_padded_);
+
+            utec::algebra::Tensor<T, 2> Y(rows, out_);
+            const int32_t zp = input_params_.zero_point;
+            #pragma omp parallel for
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < out_; ++j) {
+                    const int32_t centered = acc[i * out_ + j] - zp * weight_sums_[j];
+                    float y = input_params_.scale * weight_scales_[j] * float(centered) + bias_[j];
+                    if (fuse_relu_) y = std::max(y, 0.0f);
+                    Y[i * out_ + j] = T(y);
+                }
+            }
+            return Y;
+        }
+
+        utec::algebra::Tensor<T, 2> backward(const utec::algebra::Tensor<T, 2>&) override {
+            throw std::logic_error("QuantizedDense is inference-only");
+        }
+
+        const char* name() const override { return fuse_relu_ ? "QuantizedDense+ReLU" : "QuantizedDense"; }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<QuantizedDense<T>>(*this); }
+
+        size_t planned_output_features(size_t features) const override {
+            if (features != in_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            return out_;
+        }
+
+        bool fused_relu() const { return fuse_relu_; }
+        const QuantizationParams& input_params() const { return input_params_; }
+
+        size_t parameter_bytes() const {
+            return weights_.size() * sizeof(int8_t) + weight_scales_.size() * sizeof(float)
+                   + weight_sums_.size() * sizeof(int32_t) + bias_.size() * sizeof(float);
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
@@ -0,0 +1,204 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_SPARSE_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_SPARSE_H
+
+#include "tensor.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace utec::neural_network {
+
+    // Pone en cero la fraccion `sparsity` de pesos con menor magnitud
+    template<typename T>
+    void magnitude_prune(utec::algebra::Tensor<T, 2>& W, double sparsity) {
+        if (sparsity < 0.0 || sparsity > 1.0) {
+            throw std::invalid_argument("Sparsity must be in [0, 1]");
+        }
+        const size_t to_prune = static_cast<size_t>(std::llround(sparsity * double(W.size())));
+        if (to_prune == 0) return;
+        if (to_prune >= W.size()) {
+            W.fill(T(0));
+            return;
+        }
+
+        std::vector<T> magnitudes(W.size());
+        for (size_t i = 0; i < W.size(); ++i)
+            magnitudes[i] = std::abs(W[i]);
+        std::nth_element(magnitudes.begin(), magnitudes.begin() + to_prune, magnitudes.end());
+        const T threshold = magnitudes[to_prune];
+
+        size_t pruned = 0;
+        for (size_t i = 0; i < W.size(); ++i) {
+            if (std::abs(W[i]) < threshold) {
+                W[i] = T(0);
+                ++pruned;
+            }
+        }
+        // Empates en el umbral: completar hasta `to_prune` en orden
+        for (size_t i = 0; i < W.size() && pruned < to_prune; ++i) {
+            if (W[i] != T(0) && std::abs(W[i]) == threshold) {
+                W[i] = T(0);
+                ++pruned;
+            }
+        }
+    }
+
+    template<typename T>
+    double sparsity(const utec::algebra::Tensor<T, 2>& W) {
+        if (W.empty()) return 0.0;
+        size_t zeros = 0;
+        for (size_t i = 0; i < W.size(); ++i)
+            if (W[i] == T(0)) ++zeros;
+        return double(zeros) / double(W.size());
+    }
+
+    // Matriz dispersa CSR (rows x cols). Los valores se guardan en un Tensor 1 x nnz
+    // para que los optimizadores existentes puedan actualizarlos directamente.
+    template<typename T>
+    class CsrMatrix {
+        size_t rows_ = 0, cols_ = 0;
+        std::vector<size_t> row_ptr_;
+        std::vector<uint32_t> col_idx_;
+        utec::algebra::Tensor<T, 2> values_;
+
+        static constexpr size_t kRowBlock = 4;
+
+    public:
+        CsrMatrix() = default;
+
+        static CsrMatrix from_dense(const utec::algebra::Tensor<T, 2>& dense) {
+            CsrMatrix result;
+            result.rows_ = dense.shape()[0];
+            result.cols_ = dense.shape()[1];
+            result.row_ptr_.assign(result.rows_ + 1, 0);
+
+            size_t nnz = 0;
+            for (size_t i = 0; i < dense.size(); ++i)
+                if (dense[i] != T(0)) ++nnz;
+            result.col_idx_.reserve(nnz);
+            result.values_ = utec::algebra::Tensor<T, 2>(1, nnz);
+
+            size_t p = 0;
+            for (size_t r = 0; r < result.rows_; ++r) {
+                for (size_t c = 0; c < result.cols_; ++c) {
+                    const T v = dense[r * result.cols_ + c];
+                    if (v != T(0)) {
+                        result.col_idx_.push_back(static_cast<uint32_t>(c));
+                        result.values_[p++] = v;
+                    }
+                }
+                result.row_ptr_[r + 1] = p;
+            }
+            return result;
+        }
+
+        utec::algebra::Tensor<T, 2> to_dense() const {
+            utec::algebra::Tensor<T, 2> dense(rows_, cols_);
+            dense.fill(T(0));
+            for (size_t r = 0; r < rows_; ++r)
+                for (size_t p = row_ptr_[r]; p < row_ptr_[r + 1]; ++p)
+                    dense[r * cols_ + col_idx_[p]] = values_[p];
+            return dense;
+        }
+
+        size_t rows() const { return rows_; }
+        size_t cols() const { return cols_; }
+        size_t nnz() const { return col_idx_.size(); }
+
+        utec::algebra::Tensor<T, 2>& values() { return values_; }
+        const utec::algebra::Tensor<T, 2>& values() const { return values_; }
+
+        size_t bytes() const {
+            return row_ptr_.size() * sizeof(size_t) + col_idx_.size() * sizeof(uint32_t) + values_.size() * sizeof(T);
+        }
+
+        // Y (n x cols) += X (n x rows) * this. Bloques de kRowBlock filas de X comparten
+        // cada recorrido de la matriz CSR; se paraleliza sobre los bloques.
+        void multiply_accumulate(const T* X, size_t n, T* Y) const {
+            const size_t blocks = (n + kRowBlock - 1) / kRowBlock;
+            const T* values = values_.data();
+            const uint32_t* cols = col_idx_.data();
+
+            #pragma omp parallel for schedule(static)
+            for (size_t block = 0; block < blocks; ++block) {
+                const size_t first = block * kRowBlock;
+                const size_t count = std::min(kRowBlock, n - first);
+                if (count == kRowBlock) {
+                    const T* x0 = X + first * rows_;
+                    const T* x1 = x0 + rows_;
+                    const T* x2 = x1 + rows_;
+                    const T* x3 = x2 + rows_;
+                    T* y0 = Y + first * cols_;
+                    T* y1 = y0 + cols_;
+                    T* y2 = y1 + cols_;
+                    T* y3 = y2 + cols_;
+                    for (size_t k = 0; k < rows_; ++k) {
+                        const T a0 = x0[k], a1 = x1[k], a2 = x2[k], a3 = x3[k];
+                        if (a0 == T(0) && a1 == T(0) && a2 == T(0) && a3 == T(0)) continue;
+                        for (size_t p = row_ptr_[k]; p < row_ptr_[k + 1]; ++p) {
+                            const T v = values[p];
+                            const size_t c = cols[p];
+                            y0[c] += a0 * v;
+                            y1[c] += a1 * v;
+                            y2[c] += a2 * v;
+                            y3[c] += a3 * v;
+                        }
+                    }
+                } else {
+                    for (size_t i = first; i < first + count; ++i) {
+                        const T* x = X + i * rows_;
+                        T* y = Y + i * cols_;
+                        for (size_t k = 0; k < rows_; ++k) {
+                            const T a = x[k];
+                            if (a == T(0)) continue;
+                            for (size_t p = row_ptr_[k]; p < row_ptr_[k + 1]; ++p)
+                                y[cols[p]] += a * values[p];
+                        }
+                    }
+                }
+            }
+        }
+
+        // dX (n x rows) = dY (n x cols) * this^T
+        void multiply_transposed(const T* dY, size_t n, T* dX) const {
+            const T* values = values_.data();
+            const uint32_t* cols = col_idx_.data();
+
+            #pragma omp parallel for schedule(static)
+            for (size_t i = 0; i < n; ++i) {
+                const T* dy = dY + i * cols_;
+                T* dx = dX + i * rows_;
+                for (size_t k = 0; k < rows_; ++k) {
+                    T sum = T(0);
+                    for (size_t p = row_ptr_[k]; p < row_ptr_[k + 1]; ++p)
+                        sum += dy[cols[p]] * values[p];
+                    dx[k] = sum;
+                }
+            }
+        }
+
+        // Gradiente solo en las posiciones no nulas: g[p] = sum_i X[i][k] * dY[i][col[p]]
+        void sampled_gradient(const T* X, const T* dY, size_t n, T* grad) const {
+            const uint32_t* cols = col_idx_.data();
+
+            #pragma omp parallel for schedule(dynamic, 16)
+            for (size_t k = 0; k < rows_; ++k) {
+                const size_t begin = row_ptr_[k], end = row_ptr_[k + 1];
+                for (size_t p = begin; p < end; ++p)
+                    grad[p] = T(0);
+                for (size_t i = 0; i < n; ++i) {
+                    const T a = X[i * rows_ + k];
+                    if (a == T(0)) continue;
+                    const T* dy = dY + i * cols_;
+                    for (size_t p = begin; p < end; ++p)
+                        grad[p] += a * dy[cols[p]];
+                }
+            }
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_SPARSE_H
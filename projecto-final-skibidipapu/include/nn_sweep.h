@@ -0,0 +1,257 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_SWEEP_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_SWEEP_H
+
+#include "neural_network.h"
+#include "nn_training.h"
+#include "tensor.h"
+#include "tensor_random.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace utec::neural_network {
+
+    template<typename T>
+    struct SweepConfig {
+        size_t id = 0;
+        size_t batch_size = 128;
+        T learning_rate = T(0.01);
+        size_t hidden = 64;
+    };
+
+    // Valores candidatos de cada hiperparametro. Las epocas no se enumeran: las reparte el
+    // successive halving entre min_epochs y max_epochs (ver SweepOptions).
+    template<typename T>
+    struct SweepSpace {
+        std::vector<size_t> batch_sizes{128};
+        std::vector<T> learning_rates{T(0.01)};
+        std::vector<size_t> hidden_widths{64};
+
+        std::vector<SweepConfig<T>> grid() const {
+            std::vector<SweepConfig<T>> configs;
+            for (size_t batch : batch_sizes)
+                for (T lr : learning_rates)
+                    for (size_t hidden : hidden_widths)
+                        configs.push_back({configs.size(), batch, lr, hidden});
+            return configs;
+        }
+
+        // Busqueda aleatoria reproducible: batch y ancho se eligen de las listas y el learning
+        // rate es log-uniforme entre el menor y el mayor de learning_rates
+        std::vector<SweepConfig<T>> random(size_t count, std::uint64_t seed) const {
+            if (batch_sizes.empty() || learning_rates.empty() || hidden_widths.empty()) {
+                throw std::invalid_argument("Sweep space has an empty dimension");
+            }
+            const auto [lo, hi] = std::minmax_element(learning_rates.begin(), learning_rates.end());
+            const double log_lo = std::log(double(*lo)), log_hi = std::log(double(*hi));
+            const utec::algebra::RandomStream stream{seed, 0};
+            std::vector<SweepConfig<T>> configs;
+            for (size_t i = 0; i < count; ++i) {
+                const auto words = stream.block(i);
+                const double u = utec::algebra::detail::to_unit(words[2], words[3]);
+                configs.push_back({i, batch_sizes[words[0] % batch_sizes.size()],
+                                   T(std::exp(log_lo + u * (log_hi - log_lo))),
+                                   hidden_widths[words[1] % hidden_widths.size()]});
+            }
+            return configs;
+        }
+    };
+
+    struct SweepOptions {
+        size_t min_epochs = 10;
+        size_t max_epochs = 500;
+        // En cada ronda sobrevive 1 / eta de las configuraciones y el presupuesto se multiplica por eta
+        size_t eta = 3;
+        // 0 = un hilo por nucleo
+        size_t workers = 0;
+        std::uint64_t seed = 2025;
+    };
+
+    template<typename T>
+    struct SweepResult {
+        SweepConfig<T> config;
+        size_t rung = 0;
+        size_t epochs = 0;
+        T train_loss = 0, val_loss = 0, val_accuracy = 0;
+        double seconds = 0;
+    };
+
+    // Successive halving: todas las configuraciones entrenan min_epochs, se evaluan en
+    // validacion y solo la mejor fraccion 1 / eta sigue entrenando (sin reiniciar) hasta el
+    // siguiente presupuesto. Cada configuracion corre en un hilo con OpenMP limitado a 1
+    // hilo, asi el tiempo total escala con el numero de nucleos. Los datos se comparten
+    // sin copiar (solo lectura) y las redes se construyen en orden antes de lanzar los hilos:
+    // el resultado no depende del numero de workers.
+    template<typename T, template<typename...> class LossType = BCELoss,
+             template<typename...> class OptimizerType = SGD>
+    class HyperparameterSweep {
+    public:
+        using Builder = std::function<void(NeuralNetwork<T>&, const SweepConfig<T>&)>;
+
+    private:
+        struct Trial {
+            SweepResult<T> result;
+            NeuralNetwork<T> network;
+            std::unique_ptr<OptimizerType<T>> optimizer;
+        };
+
+        Builder builder_;
+        SweepOptions options_;
+
+        // Una perdida NaN (entrenamiento divergente) cuenta como +inf: sin esto el orden
+        // deja de ser estricto y debil y std::stable_sort puede devolver cualquier cosa
+        static bool lower_loss(T a, T b) {
+            return std::isnan(a) ? false : std::isnan(b) || a < b;
+        }
+
+        static T evaluate(NeuralNetwork<T>& network, const utec::algebra::Tensor<T, 2>& X,
+                          const utec::algebra::Tensor<T, 2>& Y, T& accuracy) {
+            MetricAccumulator<T> metrics;
+            const auto output = network.predict(X);
+            LossType<T> loss(output, Y);
+            metrics.add_batch(output, Y, loss.loss());
+            accuracy = metrics.accuracy();
+            return metrics.loss();
+        }
+
+        size_t worker_count(size_t jobs) const {
+            size_t workers = options_.workers;
+            if (workers == 0) workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+            return std::max<size_t>(1, std::min(workers, jobs));
+        }
+
+        // Cada worker toma la siguiente prueba libre; los fallos se propagan al terminar la ronda
+        template<typename F>
+        void parallel_for(size_t jobs, F&& body) const {
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            auto work = [&] {
+#ifdef _OPENMP
+                omp_set_num_threads(1);
+#endif
+                for (size_t job = next++; job < jobs; job = next++) {
+                    try {
+                        body(job);
+                    } catch (...) {
+                        std::lock_guard lock(error_mutex);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+            };
+            const size_t workers = worker_count(jobs);
+            if (workers == 1) {
+                // Sin hilos extra: el entrenamiento conserva el paralelismo de OpenMP
+                for (size_t job = 0; job < jobs; ++job) body(job);
+                return;
+            }
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; ++w) threads.emplace_back(work);
+            for (auto& thread : threads) thread.join();
+            if (error) std::rethrow_exception(error);
+        }
+
+    public:
+        HyperparameterSweep(Builder builder, SweepOptions options = {})
+                : builder_(std::move(builder)), options_(options) {
+            if (options_.min_epochs == 0 || options_.max_epochs < options_.min_epochs) {
+                throw std::invalid_argument("Sweep needs 0 < min_epochs <= max_epochs");
+            }
+            if (options_.eta < 2) {
+                throw std::invalid_argument("Successive halving needs eta >= 2");
+            }
+        }
+
+        // Devuelve una fila por configuracion, primero las que llegaron mas lejos y luego por
+        // perdida de validacion: la primera es la ganadora
+        std::vector<SweepResult<T>> run(const std::vector<SweepConfig<T>>& configs,
+                                        const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                                        const utec::algebra::Tensor<T, 2>& X_val, const utec::algebra::Tensor<T, 2>& Y_val) {
+            if (configs.empty()) {
+                throw std::invalid_argument("Sweep needs at least one configuration");
+            }
+            std::vector<Trial> trials(configs.size());
+            utec::algebra::set_global_seed(options_.seed);
+            for (size_t i = 0; i < configs.size(); ++i) {
+                trials[i].result.config = configs[i];
+                builder_(trials[i].network, configs[i]);
+                trials[i].optimizer = std::make_unique<OptimizerType<T>>(configs[i].learning_rate);
+            }
+
+            std::vector<size_t> alive(configs.size());
+            for (size_t i = 0; i < alive.size(); ++i) alive[i] = i;
+            size_t budget = options_.min_epochs;
+            for (size_t rung = 0;; ++rung) {
+                parallel_for(alive.size(), [&](size_t job) {
+                    Trial& trial = trials[alive[job]];
+                    SweepResult<T>& result = trial.result;
+                    const auto start = std::chrono::steady_clock::now();
+                    for (; result.epochs < budget; ++result.epochs) {
+                        result.train_loss = trial.network.template train_epoch<LossType>(
+                                X, Y, result.config.batch_size, *trial.optimizer, result.epochs);
+                    }
+                    result.val_loss = evaluate(trial.network, X_val, Y_val, result.val_accuracy);
+                    result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    result.rung = rung;
+                });
+                if (budget == options_.max_epochs) break;
+
+                std::stable_sort(alive.begin(), alive.end(), [&](size_t a, size_t b) {
+                    return lower_loss(trials[a].result.val_loss, trials[b].result.val_loss);
+                });
+                alive.resize(std::max<size_t>(1, alive.size() / options_.eta));
+                // La ganadora termina el presupuesto completo
+                budget = alive.size() == 1 ? options_.max_epochs : std::min(options_.max_epochs, budget * options_.eta);
+            }
+
+            std::vector<SweepResult<T>> results;
+            for (auto& trial : trials) results.push_back(trial.result);
+            std::stable_sort(results.begin(), results.end(), [](const SweepResult<T>& a, const SweepResult<T>& b) {
+                if (a.rung != b.rung) return a.rung > b.rung;
+                return lower_loss(a.val_loss, b.val_loss);
+            });
+            return results;
+        }
+    };
+
+    template<typename T>
+    void write_sweep_csv(std::ostream& os, const std::vector<SweepResult<T>>& results) {
+        os << "id,batch_size,learning_rate,hidden,rung,epochs,train_loss,val_loss,val_accuracy,seconds\n";
+        os << std::setprecision(8);
+        for (const auto& r : results) {
+            os << r.config.id << ',' << r.config.batch_size << ',' << r.config.learning_rate << ','
+               << r.config.hidden << ',' << r.rung << ',' << r.epochs << ',' << r.train_loss << ','
+               << r.val_loss << ',' << r.val_accuracy << ',' << r.seconds << '\n';
+        }
+    }
+
+    template<typename T>
+    void write_sweep_json(std::ostream& os, const std::vector<SweepResult<T>>& results) {
+        os << std::setprecision(8) << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            os << "  {\"id\": " << r.config.id << ", \"batch_size\": " << r.config.batch_size
+               << ", \"learning_rate\": " << r.config.learning_rate << ", \"hidden\": " << r.config.hidden
+               << ", \"rung\": " << r.rung << ", \"epochs\": " << r.epochs << ", \"train_loss\": " << r.train_loss
+               << ", \"val_loss\": " << r.val_loss << ", \"val_accuracy\": " << r.val_accuracy
+               << ", \"seconds\": " << r.seconds << "}" << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        os << "]\n";
+    }
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_SWEEP_H
@@ -0,0 +1,420 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TRAINING_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TRAINING_H
+
+#include "neural_network.h"
+#include "nn_interfaces.h"
+#include "nn_loss.h"
+#include "nn_optimizer.h"
+#include "tensor.h"
+#include "tensor_reduce.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Metricas acumuladas batch a batch sobre las salidas de forward que ya se calcularon.
+    // Salida de una columna: clasificacion binaria con umbral 0.5 y AUC por histograma
+    // (sin ordenar las predicciones). Varias columnas: exactitud por argmax contra one-hot
+    // o contra etiquetas N x 1; el AUC queda como NaN.
+    template<typename T>
+    class MetricAccumulator {
+        static constexpr size_t kAucBins = 1024;
+
+        utec::algebra::CompensatedSum<T> loss_;
+        size_t samples_ = 0, correct_ = 0;
+        bool binary_ = true;
+        std::array<size_t, kAucBins> positives_{}, negatives_{};
+
+        // argmax de una fila sin el Tensor<size_t> que reserva utec::algebra::argmax
+        static size_t row_argmax(const T* row, size_t cols) {
+            T best;
+            size_t index;
+            utec::algebra::detail::extreme_rows(row, cols, 1, &best, &index, 0, std::greater<T>());
+            return index;
+        }
+
+    public:
+        void reset() { *this = MetricAccumulator(); }
+
+        // batch_loss es la perdida media del batch; se pondera por sus filas
+        void add_batch(const utec::algebra::Tensor<T, 2>& prediction, const utec::algebra::Tensor<T, 2>& target,
+                       T batch_loss) {
+            const size_t rows = prediction.shape()[0], cols = prediction.shape()[1];
+            const size_t target_cols = target.shape()[1];
+            if (target.shape()[0] != rows || (target_cols != cols && target_cols != 1)) {
+                throw std::invalid_argument("Prediction and target shapes do not match");
+            }
+            loss_.add(batch_loss * T(rows));
+            samples_ += rows;
+
+            if (cols == 1) {
+                for (size_t i = 0; i < rows; ++i) {
+                    const T score = prediction[i];
+                    const bool positive = target[i] >= T(0.5);
+                    correct_ += (score >= T(0.5)) == positive;
+                    const T clamped = std::min(std::max(score, T(0)), T(1));
+                    const size_t bin = std::min(size_t(clamped * T(kAucBins)), kAucBins - 1);
+                    ++(positive ? positives_ : negatives_)[bin];
+                }
+                return;
+            }
+
+            binary_ = false;
+            for (size_t i = 0; i < rows; ++i) {
+                const size_t predicted = row_argmax(prediction.data() + i * cols, cols);
+                const size_t label = target_cols == 1 ? size_t(target[i])
+                                                      : row_argmax(target.data() + i * cols, cols);
+                correct_ += predicted == label;
+            }
+        }
+
+        size_t samples() const { return samples_; }
+        T loss() const { return samples_ ? loss_.value() / T(samples_) : T(0); }
+        T accuracy() const { return samples_ ? T(correct_) / T(samples_) : T(0); }
+
+        // Area bajo ROC: cada positivo gana a los negativos de bins inferiores y empata en el suyo
+        T auc() const {
+            size_t positives = 0, negatives = 0;
+            for (size_t b = 0; b < kAucBins; ++b) {
+                positives += positives_[b];
+                negatives += negatives_[b];
+            }
+            if (!binary_ || positives == 0 || negatives == 0) return std::numeric_limits<T>::quiet_NaN();
+
+            double area = 0, negatives_below = 0;
+            for (size_t b = 0; b < kAucBins; ++b) {
+                area += double(positives_[b]) * (negatives_below + 0.5 * double(negatives_[b]));
+                negatives_below += double(negatives_[b]);
+            }
+            return T(area / (double(positives) * double(negatives)));
+        }
+    };
+
+    template<typename T>
+    struct EpochMetrics {
+        size_t epoch = 0;
+        T loss = 0, accuracy = 0, auc = 0;
+        bool has_validation = false;
+        T val_loss = 0, val_accuracy = 0, val_auc = 0;
+        T learning_rate = 0;
+        double seconds = 0;
+    };
+
+    // Lo que los callbacks pueden cambiar: detener el entrenamiento o fijar el learning rate
+    template<typename T>
+    struct TrainingControl {
+        bool stop = false;
+        T learning_rate = 0;
+    };
+
+    template<typename T>
+    class ITrainingCallback {
+    public:
+        virtual void on_epoch_end(const EpochMetrics<T>& metrics, TrainingControl<T>& control) = 0;
+        virtual void on_train_end(const std::vector<EpochMetrics<T>>&) {}
+        // false si on_epoch_end no lee los campos val_*: con validacion asincrona se llama
+        // apenas termina la epoca en lugar de esperar a su validacion
+        virtual bool reads_validation() const { return true; }
+        virtual ~ITrainingCallback() = default;
+    };
+
+    // Detiene el entrenamiento si la perdida de validacion (o la de entrenamiento, si no hay
+    // validacion) no mejora en min_delta durante `patience` epocas
+    template<typename T>
+    class EarlyStopping final : public ITrainingCallback<T> {
+        size_t patience_;
+        T min_delta_;
+        T best_ = std::numeric_limits<T>::infinity();
+        size_t best_epoch_ = 0, wait_ = 0;
+        bool stopped_ = false;
+
+    public:
+        explicit EarlyStopping(size_t patience, T min_delta = T(0))
+                : patience_(patience), min_delta_(min_delta) {}
+
+        void on_epoch_end(const EpochMetrics<T>& metrics, TrainingControl<T>& control) override {
+            const T monitored = metrics.has_validation ? metrics.val_loss : metrics.loss;
+            if (monitored < best_ - min_delta_) {
+                best_ = monitored;
+                best_epoch_ = metrics.epoch;
+                wait_ = 0;
+            } else if (++wait_ >= patience_) {
+                stopped_ = true;
+                control.stop = true;
+            }
+        }
+
+        T best() const { return best_; }
+        size_t best_epoch() const { return best_epoch_; }
+        bool stopped() const { return stopped_; }
+    };
+
+    // Multiplica el learning rate por gamma cada step_size epocas
+    template<typename T>
+    class StepDecay final : public ITrainingCallback<T> {
+        size_t step_size_;
+        T gamma_;
+
+    public:
+        StepDecay(size_t step_size, T gamma) : step_size_(step_size), gamma_(gamma) {
+            if (step_size == 0) {
+                throw std::invalid_argument("Step size must be positive");
+            }
+        }
+
+        void on_epoch_end(const EpochMetrics<T>& metrics, TrainingControl<T>& control) override {
+            if ((metrics.epoch + 1) % step_size_ == 0) control.learning_rate *= gamma_;
+        }
+
+        bool reads_validation() const override { return false; }
+    };
+
+    template<typename T>
+    class ExponentialDecay final : public ITrainingCallback<T> {
+        T gamma_;
+
+    public:
+        explicit ExponentialDecay(T gamma) : gamma_(gamma) {}
+
+        void on_epoch_end(const EpochMetrics<T>&, TrainingControl<T>& control) override {
+            control.learning_rate *= gamma_;
+        }
+
+        bool reads_validation() const override { return false; }
+    };
+
+    // Formatea cada `every` epocas y escribe desde un hilo propio: el bucle de
+    // entrenamiento nunca espera a la consola
+    template<typename T>
+    class ProgressLogger final : public ITrainingCallback<T> {
+        std::ostream& os_;
+        size_t every_;
+        std::mutex mutex_;
+        std::condition_variable pending_, drained_;
+        std::deque<std::string> lines_;
+        bool writing_ = false, done_ = false;
+        std::thread writer_;
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                pending_.wait(lock, [this] { return done_ || !lines_.empty(); });
+                while (!lines_.empty()) {
+                    std::string line = std::move(lines_.front());
+                    lines_.pop_front();
+                    writing_ = true;
+                    lock.unlock();
+                    os_ << line;
+                    lock.lock();
+                    writing_ = false;
+                }
+                os_.flush();
+                drained_.notify_all();
+                if (done_) return;
+            }
+        }
+
+    public:
+        explicit ProgressLogger(std::ostream& os = std::cout, size_t every = 1)
+                : os_(os), every_(std::max<size_t>(every, 1)), writer_([this] { run(); }) {}
+
+        ProgressLogger(const ProgressLogger&) = delete;
+        ProgressLogger& operator=(const ProgressLogger&) = delete;
+
+        ~ProgressLogger() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+            }
+            pending_.notify_one();
+            writer_.join();
+        }
+
+        void on_epoch_end(const EpochMetrics<T>& metrics, TrainingControl<T>&) override {
+            if (metrics.epoch != 0 && (metrics.epoch + 1) % every_ != 0) return;
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(4) << "Epoca " << (metrics.epoch + 1)
+                 << " - loss " << metrics.loss << " - acc " << metrics.accuracy;
+            if (!std::isnan(metrics.auc)) line << " - auc " << metrics.auc;
+            if (metrics.has_validation) {
+                line << " | val_loss " << metrics.val_loss << " - val_acc " << metrics.val_accuracy;
+                if (!std::isnan(metrics.val_auc)) line << " - val_auc " << metrics.val_auc;
+            }
+            line << " - lr " << metrics.learning_rate << " - " << metrics.seconds << " s\n";
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lines_.push_back(line.str());
+            }
+            pending_.notify_one();
+        }
+
+        // Espera a que se escriban las lineas pendientes
+        void on_train_end(const std::vector<EpochMetrics<T>>&) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            drained_.wait(lock, [this] { return lines_.empty() && !writing_; });
+        }
+    };
+
+    namespace detail {
+        template<typename T>
+        utec::algebra::Tensor<T, 2> slice_rows(const utec::algebra::Tensor<T, 2>& source, size_t start, size_t rows) {
+            const size_t cols = source.shape()[1];
+            utec::algebra::Tensor<T, 2> slice(rows, cols);
+            std::copy(source.data() + start * cols, source.data() + (start + rows) * cols, slice.data());
+            return slice;
+        }
+    }
+
+    // Entrenamiento por epocas con metricas acumuladas durante forward, validacion sobre una
+    // copia de los parametros y callbacks. Con validacion asincrona, la validacion de la epoca e
+    // corre en otro hilo mientras se entrena la e + 1. Los callbacks que no leen la validacion
+    // (los schedules) reciben la epoca e al terminarla, igual que sin validacion asincrona; los
+    // demas la reciben al terminar la e + 1: una detencion temprana cuesta a lo sumo una epoca extra.
+    template<typename T, template<typename...> class LossType = BCELoss,
+             template<typename...> class OptimizerType = SGD>
+    class Trainer {
+        struct Validation {
+            T loss, accuracy, auc;
+        };
+
+        NeuralNetwork<T>& network_;
+        std::vector<std::unique_ptr<ITrainingCallback<T>>> callbacks_;
+        const utec::algebra::Tensor<T, 2>* X_val_ = nullptr;
+        const utec::algebra::Tensor<T, 2>* Y_val_ = nullptr;
+        bool async_validation_ = true;
+        std::vector<EpochMetrics<T>> history_;
+
+        static Validation evaluate(NeuralNetwork<T>& model, const utec::algebra::Tensor<T, 2>& X,
+                                   const utec::algebra::Tensor<T, 2>& Y, size_t batch_size) {
+            MetricAccumulator<T> metrics;
+            for (size_t start = 0; start < X.shape()[0]; start += batch_size) {
+                const size_t rows = std::min(batch_size, X.shape()[0] - start);
+                const auto y_batch = detail::slice_rows(Y, start, rows);
+                const auto output = model.predict(detail::slice_rows(X, start, rows));
+                LossType<T> loss(output, y_batch);
+                metrics.add_batch(output, y_batch, loss.loss());
+            }
+            return {metrics.loss(), metrics.accuracy(), metrics.auc()};
+        }
+
+        void run_callbacks(const EpochMetrics<T>& metrics, TrainingControl<T>& control,
+                           bool training, bool validation) {
+            for (auto& callback : callbacks_)
+                if (callback->reads_validation() ? validation : training)
+                    callback->on_epoch_end(metrics, control);
+        }
+
+    public:
+        explicit Trainer(NeuralNetwork<T>& network) : network_(network) {}
+
+        Trainer& add_callback(std::unique_ptr<ITrainingCallback<T>> callback) {
+            callbacks_.push_back(std::move(callback));
+            return *this;
+        }
+
+        template<typename Callback, typename... Args>
+        Callback& emplace_callback(Args&&... args) {
+            auto callback = std::make_unique<Callback>(std::forward<Args>(args)...);
+            Callback& ref = *callback;
+            callbacks_.push_back(std::move(callback));
+            return ref;
+        }
+
+        // X e Y se referencian: deben vivir hasta que termine fit
+        Trainer& validate_on(const utec::algebra::Tensor<T, 2>& X, const utec::algebra::Tensor<T, 2>& Y,
+                             bool async = true) {
+            if (X.shape()[0] != Y.shape()[0]) {
+                throw std::invalid_argument("Validation inputs and targets have different row counts");
+            }
+            X_val_ = &X;
+            Y_val_ = &Y;
+            async_validation_ = async;
+            return *this;
+        }
+
+        const std::vector<EpochMetrics<T>>& history() const { return history_; }
+
+        const std::vector<EpochMetrics<T>>& fit(const utec::algebra::Tensor<T, 2>& X,
+                                                const utec::algebra::Tensor<T, 2>& Y,
+                                                size_t epochs, size_t batch_size, T lr) {
+            OptimizerType<T> optimizer(lr);
+            TrainingControl<T> control{false, lr};
+            MetricAccumulator<T> train_metrics;
+            history_.clear();
+
+            std::future<Validation> pending;
+            EpochMetrics<T> pending_metrics;
+            auto finish_validation = [&](bool training_callbacks) {
+                const Validation result = pending.get();
+                pending_metrics.val_loss = result.loss;
+                pending_metrics.val_accuracy = result.accuracy;
+                pending_metrics.val_auc = result.auc;
+                history_.push_back(pending_metrics);
+                run_callbacks(history_.back(), control, training_callbacks, true);
+            };
+
+            for (size_t epoch = 0; epoch < epochs && !control.stop; ++epoch) {
+                train_metrics.reset();
+                const auto start = std::chrono::steady_clock::now();
+                network_.template train_epoch<LossType>(
+                        X, Y, batch_size, optimizer, epoch,
+                        [&train_metrics](const utec::algebra::Tensor<T, 2>& output,
+                                         const utec::algebra::Tensor<T, 2>& target, T batch_loss) {
+                            train_metrics.add_batch(output, target, batch_loss);
+                        });
+
+                EpochMetrics<T> metrics;
+                metrics.epoch = epoch;
+                metrics.loss = train_metrics.loss();
+                metrics.accuracy = train_metrics.accuracy();
+                metrics.auc = train_metrics.auc();
+                metrics.learning_rate = control.learning_rate;
+                metrics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                if (!X_val_) {
+                    history_.push_back(metrics);
+                    run_callbacks(history_.back(), control, true, true);
+                } else {
+                    // La validacion de la epoca anterior corrio en paralelo con esta
+                    if (pending.valid()) finish_validation(false);
+                    if (async_validation_) run_callbacks(metrics, control, true, false);
+                    metrics.has_validation = true;
+                    pending_metrics = metrics;
+                    pending = std::async(async_validation_ ? std::launch::async : std::launch::deferred,
+                                         [model = network_.snapshot(), this, batch_size]() mutable {
+                                             return evaluate(model, *X_val_, *Y_val_, batch_size);
+                                         });
+                    if (!async_validation_) finish_validation(true);
+                }
+
+                if (control.learning_rate != optimizer.learning_rate())
+                    optimizer.set_learning_rate(control.learning_rate);
+            }
+            if (pending.valid()) finish_validation(false);
+
+            for (auto& callback : callbacks_)
+                callback->on_train_end(history_);
+            return history_;
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TRAINING_H
@@ -6,6 +6,13 @@
 #include <numeric>
 #include <initializer_list>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include "tensor_reduce.h"
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -13,70 +20,481 @@
 namespace utec {
 namespace algebra {
 
+namespace detail {
+
+// Bytes reservados por los tensores en el hilo actual. El contador es por hilo: el perfilador
+// mide lo que reserva cada capa sin sumar lo que hacen otros hilos (p. ej. la validacion en
+// segundo plano). Solo cuenta con UTEC_NN_PROFILING; sin el macro Tensor usa std::allocator
+// y el contador queda en 0. El macro debe ser el mismo en todo el programa (lo define CMake
+// con UTEC_ENABLE_PROFILING), igual que kProfilingEnabled en nn_profiler.h.
+inline size_t& thread_allocated_bytes() {
+    thread_local size_t counter = 0;
+    return counter;
+}
+
+inline size_t allocated_bytes() { return thread_allocated_bytes(); }
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() noexcept = default;
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        thread_allocated_bytes() += n * sizeof(T);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+};
+
+#ifdef UTEC_NN_PROFILING
+template<typename T>
+using TensorAllocator = CountingAllocator<T>;
+#else
+template<typename T>
+using TensorAllocator = std::allocator<T>;
+#endif
+
+}
+
 template<typename T, size_t Rank>
-class Tensor {
-private:
-    std::array<size_t, Rank> shape_;
-    std::vector<T> data_;
+class Tensor;
 
-    template<typename... Idxs>
-    size_t calculate_index(Idxs... idxs) const {
-        static_assert(sizeof...(idxs) == Rank, "Number of indices must match tensor rank");
-        std::array<size_t, Rank> indices = {static_cast<size_t>(idxs)...};
+namespace detail {
 
-        size_t linear_index = 0;
-        size_t stride = 1;
+struct ExpressionTag {};
 
-        for (int i = Rank - 1; i >= 0; --i) {
-            if (indices[i] >= shape_[i]) {
+template<typename E, typename = void>
+struct operand_traits {};
+
+template<typename T, size_t Rank>
+struct operand_traits<Tensor<T, Rank>> {
+    using value_type = T;
+    static constexpr size_t rank = Rank;
+};
+
+template<typename E>
+struct operand_traits<E, std::enable_if_t<std::is_base_of_v<ExpressionTag, E>>> {
+    using value_type = typename E::value_type;
+    static constexpr size_t rank = E::rank;
+};
+
+template<typename E, typename = void>
+struct is_operand : std::false_type {};
+
+template<typename E>
+struct is_operand<E, std::void_t<typename operand_traits<E>::value_type>> : std::true_type {};
+
+template<typename E>
+constexpr bool is_operand_v = is_operand<std::decay_t<E>>::value;
+
+template<typename E>
+using operand_value_t = typename operand_traits<std::decay_t<E>>::value_type;
+
+template<typename L, typename R, typename = void>
+struct are_compatible_operands : std::false_type {};
+
+template<typename L, typename R>
+struct are_compatible_operands<L, R, std::enable_if_t<is_operand_v<L> && is_operand_v<R>>>
+    : std::bool_constant<
+        std::is_same_v<operand_value_t<L>, operand_value_t<R>> &&
+        operand_traits<std::decay_t<L>>::rank == operand_traits<std::decay_t<R>>::rank> {};
+
+template<typename L, typename R>
+constexpr bool are_compatible_operands_v = are_compatible_operands<L, R>::value;
+
+// Stride 0 en las dimensiones de tamano 1: el broadcasting se resuelve una sola vez
+template<size_t Rank>
+std::array<size_t, Rank> broadcast_strides(const std::array<size_t, Rank>& shape) {
+    std::array<size_t, Rank> strides{};
+    size_t stride = 1;
+    for (size_t d = Rank; d-- > 0;) {
+        strides[d] = shape[d] == 1 ? 0 : stride;
+        stride *= shape[d];
+    }
+    return strides;
+}
+
+// Recorre la expresion una sola vez; sin broadcasting el indice es lineal
+template<typename E, typename T>
+void evaluate(const E& expr, T* out) {
+    constexpr size_t Rank = E::rank;
+    const auto& shape = expr.shape();
+    const size_t n = std::accumulate(shape.begin(), shape.end(), size_t{1}, std::multiplies<size_t>());
+    if (n == 0) return;
+
+    if (expr.matches(shape)) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = expr.at(i);
+        }
+        return;
+    }
+
+    const size_t inner = shape[Rank - 1];
+    std::array<size_t, Rank> idx{};
+    for (size_t base = 0; base < n; base += inner) {
+        for (size_t j = 0; j < inner; ++j) {
+            idx[Rank - 1] = j;
+            out[base + j] = expr.at(idx);
+        }
+        for (size_t d = Rank - 1; d-- > 0;) {
+            if (++idx[d] < shape[d]) break;
+            idx[d] = 0;
+        }
+    }
+}
+
+}
+
+// Base CRTP de las expresiones perezosas: nada se calcula hasta asignarlas a un Tensor.
+// Son opcionales: entre Tensor los operadores devuelven un Tensor (ver lazy()).
+template<typename Derived, typename T, size_t Rank>
+class TensorExpression : public detail::ExpressionTag {
+public:
+    using value_type = T;
+    static constexpr size_t rank = Rank;
+
+    const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+    size_t size() const {
+        const auto& shape = derived().shape();
+        return std::accumulate(shape.begin(), shape.end(), size_t{1}, std::multiplies<size_t>());
+    }
+
+    template<typename... Idxs>
+    T operator()(Idxs... idxs) const {
+        static_assert(sizeof...(idxs) == Rank, "Number of indices must match tensor rank");
+        const std::array<size_t, Rank> indices = {static_cast<size_t>(idxs)...};
+        const auto& shape = derived().shape();
+        for (size_t i = 0; i < Rank; ++i) {
+            if (indices[i] >= shape[i]) {
                 throw std::out_of_range("Index out of bounds");
             }
-            linear_index += indices[i] * stride;
-            stride *= shape_[i];
         }
+        return derived().at(indices);
+    }
 
-        return linear_index;
+    T operator[](size_t linear) const {
+        const auto& shape = derived().shape();
+        if (derived().matches(shape)) return derived().at(linear);
+        std::array<size_t, Rank> indices;
+        for (size_t d = Rank; d-- > 0;) {
+            indices[d] = linear % shape[d];
+            linear /= shape[d];
+        }
+        return derived().at(indices);
     }
 
-    size_t total_size() const {
-        return std::accumulate(shape_.begin(), shape_.end(), size_t{1}, std::multiplies<size_t>());
+    Tensor<T, Rank> eval() const { return Tensor<T, Rank>(*this); }
+
+    friend std::ostream& operator<<(std::ostream& os, const TensorExpression& expr) {
+        return os << expr.eval();
     }
+};
+
+// Hoja: referencia a un Tensor con nombre, o lo guarda por valor si es temporal
+template<typename T, size_t Rank, typename Holder>
+class TensorOperand : public TensorExpression<TensorOperand<T, Rank, Holder>, T, Rank> {
+    Holder tensor_;
+    std::array<size_t, Rank> strides_;
+
+public:
+    template<typename Arg>
+    explicit TensorOperand(Arg&& tensor)
+        : tensor_(std::forward<Arg>(tensor)), strides_(detail::broadcast_strides(tensor_.shape())) {}
 
-    bool is_broadcast_compatible(const std::array<size_t, Rank>& other_shape) const {
+    const std::array<size_t, Rank>& shape() const noexcept { return tensor_.shape(); }
+
+    bool matches(const std::array<size_t, Rank>& shape) const noexcept { return tensor_.shape() == shape; }
+
+    T at(size_t linear) const { return tensor_.data()[linear]; }
+
+    T at(const std::array<size_t, Rank>& idx) const {
+        size_t offset = 0;
+        for (size_t d = 0; d < Rank; ++d) {
+            offset += idx[d] * strides_[d];
+        }
+        return tensor_.data()[offset];
+    }
+};
+
+template<typename Op, typename L, typename R>
+class BinaryExpression : public TensorExpression<BinaryExpression<Op, L, R>, typename L::value_type, L::rank> {
+    using T = typename L::value_type;
+    static constexpr size_t Rank = L::rank;
+
+    L lhs_;
+    R rhs_;
+    std::array<size_t, Rank> shape_;
+    Op op_;
+
+public:
+    BinaryExpression(L lhs, R rhs) : lhs_(std::move(lhs)), rhs_(std::move(rhs)) {
+        const auto& a = lhs_.shape();
+        const auto& b = rhs_.shape();
         for (size_t i = 0; i < Rank; ++i) {
-            if (shape_[i] != other_shape[i] && shape_[i] != 1 && other_shape[i] != 1) {
-                return false;
+            if (a[i] != b[i] && a[i] != 1 && b[i] != 1) {
+                throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
             }
+            shape_[i] = std::max(a[i], b[i]);
         }
-        return true;
     }
 
-    size_t broadcast_index(size_t linear_idx, const std::array<size_t, Rank>& target_shape) const {
-        std::array<size_t, Rank> multi_idx;
-        size_t temp = linear_idx;
+    const std::array<size_t, Rank>& shape() const noexcept { return shape_; }
 
-        for (int i = Rank - 1; i >= 0; --i) {
-            multi_idx[i] = temp % target_shape[i];
-            temp /= target_shape[i];
+    bool matches(const std::array<size_t, Rank>& shape) const noexcept {
+        return lhs_.matches(shape) && rhs_.matches(shape);
+    }
+
+    T at(size_t linear) const { return op_(lhs_.at(linear), rhs_.at(linear)); }
+    T at(const std::array<size_t, Rank>& idx) const { return op_(lhs_.at(idx), rhs_.at(idx)); }
+};
+
+template<typename Op, typename E, bool ScalarOnLeft = false>
+class ScalarExpression : public TensorExpression<ScalarExpression<Op, E, ScalarOnLeft>, typename E::value_type, E::rank> {
+    using T = typename E::value_type;
+    static constexpr size_t Rank = E::rank;
+
+    E expr_;
+    T scalar_;
+    Op op_;
+
+    T apply(const T& value) const {
+        if constexpr (ScalarOnLeft) return op_(scalar_, value);
+        else return op_(value, scalar_);
+    }
+
+public:
+    ScalarExpression(E expr, const T& scalar) : expr_(std::move(expr)), scalar_(scalar) {}
+
+    const std::array<size_t, Rank>& shape() const noexcept { return expr_.shape(); }
+
+    bool matches(const std::array<size_t, Rank>& shape) const noexcept { return expr_.matches(shape); }
+
+    T at(size_t linear) const { return apply(expr_.at(linear)); }
+    T at(const std::array<size_t, Rank>& idx) const { return apply(expr_.at(idx)); }
+};
+
+namespace detail {
+
+template<typename E>
+auto make_operand(E&& operand) {
+    using D = std::decay_t<E>;
+    if constexpr (std::is_base_of_v<ExpressionTag, D>) {
+        return D(std::forward<E>(operand));
+    } else if constexpr (std::is_lvalue_reference_v<E>) {
+        return TensorOperand<typename operand_traits<D>::value_type, operand_traits<D>::rank, const D&>(operand);
+    } else {
+        return TensorOperand<typename operand_traits<D>::value_type, operand_traits<D>::rank, D>(std::move(operand));
+    }
+}
+
+template<typename Op, typename L, typename R>
+auto make_binary(L&& lhs, R&& rhs) {
+    auto a = make_operand(std::forward<L>(lhs));
+    auto b = make_operand(std::forward<R>(rhs));
+    return BinaryExpression<Op, decltype(a), decltype(b)>(std::move(a), std::move(b));
+}
+
+template<typename Op, bool ScalarOnLeft, typename E>
+auto make_scalar(E&& expr, const operand_value_t<E>& scalar) {
+    auto a = make_operand(std::forward<E>(expr));
+    return ScalarExpression<Op, decltype(a), ScalarOnLeft>(std::move(a), scalar);
+}
+
+template<typename L, typename R = L>
+constexpr bool any_expression_v = std::is_base_of_v<ExpressionTag, std::decay_t<L>> ||
+                                  std::is_base_of_v<ExpressionTag, std::decay_t<R>>;
+
+// Sin ninguna expresion entre los operandos el resultado se evalua en el acto: el mismo
+// recorrido de una pasada, pero devuelve un Tensor como antes de las expresiones
+template<bool Lazy, typename E>
+auto finish(E expr) {
+    if constexpr (Lazy) return expr;
+    else return Tensor<typename E::value_type, E::rank>(expr);
+}
+
+// Transpuesta por bloques: bloques de cache de 64 x 64 recorridos en micro-bloques de 8 x 8
+// que se transponen en registros (SSE2/AVX para float y double, escalar en otro caso)
+constexpr size_t kTransposeTile = 8;
+constexpr size_t kTransposeBlock = 64;
+constexpr size_t kParallelTransposeWork = size_t(1) << 14;
+
+// dst (cols x rows, stride ld_dst) = src^T (rows x cols, stride ld_src)
+template<typename T>
+inline void transpose_edge(const T* src, size_t ld_src, T* dst, size_t ld_dst, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * ld_dst + i] = src[i * ld_src + j];
+}
+
+template<typename T>
+inline void transpose_tile(const T* src, size_t ld_src, T* dst, size_t ld_dst) {
+#if defined(__AVX__)
+    if constexpr (std::is_same_v<T, float>) {
+        __m256 r[8], t[8];
+        for (size_t i = 0; i < 8; ++i) r[i] = _mm256_loadu_ps(src + i * ld_src);
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (size_t i = 0; i < 8; i += 4) {
+            r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            _mm256_storeu_ps(dst + i * ld_dst, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+            _mm256_storeu_ps(dst + (i + 4) * ld_dst, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+        }
+        return;
+    } else if constexpr (std::is_same_v<T, double>) {
+        for (size_t bi = 0; bi < 8; bi += 4)
+            for (size_t bj = 0; bj < 8; bj += 4) {
+                const T* s = src + bi * ld_src + bj;
+                T* d = dst + bj * ld_dst + bi;
+                const __m256d r0 = _mm256_loadu_pd(s), r1 = _mm256_loadu_pd(s + ld_src);
+                const __m256d r2 = _mm256_loadu_pd(s + 2 * ld_src), r3 = _mm256_loadu_pd(s + 3 * ld_src);
+                const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+                const __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+                _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+                _mm256_storeu_pd(d + ld_dst, _mm256_permute2f128_pd(t1, t3, 0x20));
+                _mm256_storeu_pd(d + 2 * ld_dst, _mm256_permute2f128_pd(t0, t2, 0x31));
+                _mm256_storeu_pd(d + 3 * ld_dst, _mm256_permute2f128_pd(t1, t3, 0x31));
+            }
+        return;
+    }
+#elif defined(__SSE2__)
+    if constexpr (std::is_same_v<T, float>) {
+        for (size_t bi = 0; bi < 8; bi += 4)
+            for (size_t bj = 0; bj < 8; bj += 4) {
+                const T* s = src + bi * ld_src + bj;
+                T* d = dst + bj * ld_dst + bi;
+                __m128 r0 = _mm_loadu_ps(s), r1 = _mm_loadu_ps(s + ld_src);
+                __m128 r2 = _mm_loadu_ps(s + 2 * ld_src), r3 = _mm_loadu_ps(s + 3 * ld_src);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(d, r0);
+                _mm_storeu_ps(d + ld_dst, r1);
+                _mm_storeu_ps(d + 2 * ld_dst, r2);
+                _mm_storeu_ps(d + 3 * ld_dst, r3);
+            }
+        return;
+    } else if constexpr (std::is_same_v<T, double>) {
+        for (size_t bi = 0; bi < 8; bi += 2)
+            for (size_t bj = 0; bj < 8; bj += 2) {
+                const T* s = src + bi * ld_src + bj;
+                T* d = dst + bj * ld_dst + bi;
+                const __m128d r0 = _mm_loadu_pd(s), r1 = _mm_loadu_pd(s + ld_src);
+                _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+                _mm_storeu_pd(d + ld_dst, _mm_unpackhi_pd(r0, r1));
+            }
+        return;
+    }
+#endif
+    transpose_edge(src, ld_src, dst, ld_dst, kTransposeTile, kTransposeTile);
+}
+
+// Micro-bloque de hasta 8 x 8: en registros si esta completo
+template<typename T>
+inline void transpose_small(const T* src, size_t ld_src, T* dst, size_t ld_dst, size_t rows, size_t cols) {
+    if (rows == kTransposeTile && cols == kTransposeTile) transpose_tile(src, ld_src, dst, ld_dst);
+    else transpose_edge(src, ld_src, dst, ld_dst, rows, cols);
+}
+
+// dst_b (cols x rows) = src_b^T para cada matriz del lote; en paralelo por lote y franja de filas
+template<typename T>
+void transpose(const T* src, T* dst, size_t batch, size_t rows, size_t cols) {
+    const size_t row_blocks = (rows + kTransposeBlock - 1) / kTransposeBlock;
+    #pragma omp parallel for collapse(2) if(batch * rows * cols >= kParallelTransposeWork)
+    for (size_t b = 0; b < batch; ++b) {
+        for (size_t rb = 0; rb < row_blocks; ++rb) {
+            const T* s = src + b * rows * cols;
+            T* d = dst + b * rows * cols;
+            const size_t i0 = rb * kTransposeBlock, i1 = std::min(rows, i0 + kTransposeBlock);
+            for (size_t j0 = 0; j0 < cols; j0 += kTransposeBlock) {
+                const size_t j1 = std::min(cols, j0 + kTransposeBlock);
+                for (size_t i = i0; i < i1; i += kTransposeTile)
+                    for (size_t j = j0; j < j1; j += kTransposeTile)
+                        transpose_small(s + i * cols + j, cols, d + j * rows + i, rows,
+                                        std::min(kTransposeTile, i1 - i), std::min(kTransposeTile, j1 - j));
+            }
         }
+    }
+}
 
-        for (size_t i = 0; i < Rank; ++i) {
-            if (shape_[i] == 1 && target_shape[i] > 1) {
-                multi_idx[i] = 0;
+// Transpuesta en el lugar de matrices n x n: cada par de micro-bloques (i, j) / (j, i) se
+// transpone a buffers en pila y se intercambia; los bloques de la diagonal van y vuelven
+template<typename T>
+void transpose_square_in_place(T* data, size_t batch, size_t n) {
+    const size_t tiles = (n + kTransposeTile - 1) / kTransposeTile;
+    #pragma omp parallel for collapse(2) schedule(dynamic) if(batch * n * n >= kParallelTransposeWork)
+    for (size_t b = 0; b < batch; ++b) {
+        for (size_t ti = 0; ti < tiles; ++ti) {
+            T* m = data + b * n * n;
+            T upper[kTransposeTile * kTransposeTile], lower[kTransposeTile * kTransposeTile];
+            const size_t i = ti * kTransposeTile, h = std::min(kTransposeTile, n - i);
+            for (size_t tj = ti; tj < tiles; ++tj) {
+                const size_t j = tj * kTransposeTile, w = std::min(kTransposeTile, n - j);
+                // upper: bloque (i, j) transpuesto, w x h; lower: bloque (j, i) transpuesto, h x w
+                transpose_small(m + i * n + j, n, upper, h, h, w);
+                if (tj != ti) transpose_small(m + j * n + i, n, lower, w, w, h);
+                for (size_t r = 0; r < w; ++r)
+                    std::copy(upper + r * h, upper + (r + 1) * h, m + (j + r) * n + i);
+                if (tj != ti) {
+                    for (size_t r = 0; r < h; ++r)
+                        std::copy(lower + r * w, lower + (r + 1) * w, m + (i + r) * n + j);
+                }
             }
         }
+    }
+}
+
+}
 
-        size_t result = 0;
+template<typename T, size_t Rank>
+class Tensor {
+private:
+    std::array<size_t, Rank> shape_;
+    std::vector<T, detail::TensorAllocator<T>> data_;
+
+    template<typename... Idxs>
+    size_t calculate_index(Idxs... idxs) const {
+        static_assert(sizeof...(idxs) == Rank, "Number of indices must match tensor rank");
+        std::array<size_t, Rank> indices = {static_cast<size_t>(idxs)...};
+
+        size_t linear_index = 0;
         size_t stride = 1;
+
         for (int i = Rank - 1; i >= 0; --i) {
-            result += multi_idx[i] * stride;
+            if (indices[i] >= shape_[i]) {
+                throw std::out_of_range("Index out of bounds");
+            }
+            linear_index += indices[i] * stride;
             stride *= shape_[i];
         }
 
-        return result;
+        return linear_index;
+    }
+
+    size_t total_size() const {
+        return std::accumulate(shape_.begin(), shape_.end(), size_t{1}, std::multiplies<size_t>());
     }
 
 public:
+    using value_type = T;
+    static constexpr size_t rank = Rank;
+
     Tensor() : shape_(), data_() {}
 
     explicit Tensor(const std::array<size_t, Rank>& shape)
@@ -95,6 +513,24 @@ public:
         data_.resize(total_size());
     }
 
+    // Materializa una expresion perezosa en un solo recorrido
+    template<typename E>
+    Tensor(const TensorExpression<E, T, Rank>& expr)
+        : shape_(expr.derived().shape()), data_(total_size()) {
+        detail::evaluate(expr.derived(), data_.data());
+    }
+
+    // Con la misma forma se evalua en el lugar: cada elemento solo lee su propia posicion
+    template<typename E>
+    Tensor& operator=(const TensorExpression<E, T, Rank>& expr) {
+        if (expr.derived().shape() == shape_) {
+            detail::evaluate(expr.derived(), data_.data());
+        } else {
+            *this = Tensor(expr);
+        }
+        return *this;
+    }
+
     template<typename... Idxs>
     T& operator()(Idxs... idxs) {
         return data_[calculate_index(idxs...)];
@@ -151,104 +587,6 @@ public:
         return *this;
     }
 
-    Tensor operator+(const Tensor& other) const {
-        if (!is_broadcast_compatible(other.shape_)) {
-            throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
-        }
-
-        std::array<size_t, Rank> result_shape;
-        for (size_t i = 0; i < Rank; ++i) {
-            result_shape[i] = std::max(shape_[i], other.shape_[i]);
-        }
-
-        Tensor result(result_shape);
-        size_t result_size = result.total_size();
-
-        for (size_t i = 0; i < result_size; ++i) {
-            size_t idx1 = broadcast_index(i, result_shape);
-            size_t idx2 = other.broadcast_index(i, result_shape);
-            result.data_[i] = data_[idx1] + other.data_[idx2];
-        }
-
-        return result;
-    }
-
-    Tensor operator-(const Tensor& other) const {
-        if (!is_broadcast_compatible(other.shape_)) {
-            throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
-        }
-
-        std::array<size_t, Rank> result_shape;
-        for (size_t i = 0; i < Rank; ++i) {
-            result_shape[i] = std::max(shape_[i], other.shape_[i]);
-        }
-
-        Tensor result(result_shape);
-        size_t result_size = result.total_size();
-
-        for (size_t i = 0; i < result_size; ++i) {
-            size_t idx1 = broadcast_index(i, result_shape);
-            size_t idx2 = other.broadcast_index(i, result_shape);
-            result.data_[i] = data_[idx1] - other.data_[idx2];
-        }
-
-        return result;
-    }
-
-    Tensor operator*(const Tensor& other) const {
-        if (!is_broadcast_compatible(other.shape_)) {
-            throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
-        }
-
-        std::array<size_t, Rank> result_shape;
-        for (size_t i = 0; i < Rank; ++i) {
-            result_shape[i] = std::max(shape_[i], other.shape_[i]);
-        }
-
-        Tensor result(result_shape);
-        size_t result_size = result.total_size();
-
-        for (size_t i = 0; i < result_size; ++i) {
-            size_t idx1 = broadcast_index(i, result_shape);
-            size_t idx2 = other.broadcast_index(i, result_shape);
-            result.data_[i] = data_[idx1] * other.data_[idx2];
-        }
-
-        return result;
-    }
-
-    Tensor operator+(const T& scalar) const {
-        Tensor result = *this;
-        for (auto& val : result.data_) {
-            val += scalar;
-        }
-        return result;
-    }
-
-    Tensor operator-(const T& scalar) const {
-        Tensor result = *this;
-        for (auto& val : result.data_) {
-            val -= scalar;
-        }
-        return result;
-    }
-
-    Tensor operator*(const T& scalar) const {
-        Tensor result = *this;
-        for (auto& val : result.data_) {
-            val *= scalar;
-        }
-        return result;
-    }
-
-    Tensor operator/(const T& scalar) const {
-        Tensor result = *this;
-        for (auto& val : result.data_) {
-            val /= scalar;
-        }
-        return result;
-    }
-
     Tensor& operator+=(const T& scalar) {
         for (auto& val : data_) {
             val += scalar;
@@ -264,34 +602,24 @@ public:
             std::swap(new_shape[Rank-2], new_shape[Rank-1]);
 
             Tensor result(new_shape);
+            const size_t rows = shape_[Rank-2], cols = shape_[Rank-1];
+            const size_t total_batches = rows * cols == 0 ? 0 : data_.size() / (rows * cols);
+            detail::transpose(data_.data(), result.data_.data(), total_batches, rows, cols);
+            return result;
+        }
+    }
 
-            if constexpr (Rank == 2) {
-                for (size_t i = 0; i < shape_[0]; ++i) {
-                    for (size_t j = 0; j < shape_[1]; ++j) {
-                        result(j, i) = (*this)(i, j);
-                    }
-                }
-            } else {
-                size_t total_batches = 1;
-                for (size_t i = 0; i < Rank - 2; ++i) {
-                    total_batches *= shape_[i];
-                }
-
-                size_t rows = shape_[Rank-2];
-                size_t cols = shape_[Rank-1];
-
-                for (size_t batch = 0; batch < total_batches; ++batch) {
-                    for (size_t i = 0; i < rows; ++i) {
-                        for (size_t j = 0; j < cols; ++j) {
-                            size_t src_idx = batch * rows * cols + i * cols + j;
-                            size_t dst_idx = batch * rows * cols + j * rows + i;
-                            result.data_[dst_idx] = data_[src_idx];
-                        }
-                    }
-                }
+    // Sin reservar memoria; las dos ultimas dimensiones deben ser iguales
+    void transpose_in_place() {
+        if constexpr (Rank < 2) {
+            throw std::invalid_argument("Cannot transpose 1D tensor: need at least 2 dimensions");
+        } else {
+            const size_t n = shape_[Rank-1];
+            if (shape_[Rank-2] != n) {
+                throw std::invalid_argument("In-place transpose requires square matrices");
             }
-
-            return result;
+            if (n == 0) return;
+            detail::transpose_square_in_place(data_.data(), data_.size() / (n * n), n);
         }
     }
 
@@ -300,6 +628,9 @@ public:
     auto cbegin() const { return data_.cbegin(); }
     auto cend() const { return data_.cend(); }
 
+    T* data() noexcept { return data_.data(); }
+    const T* data() const noexcept { return data_.data(); }
+
     T& operator[](size_t idx) { return data_[idx]; }
     const T& operator[](size_t idx) const { return data_[idx]; }
     size_t size() const { return data_.size(); }
@@ -313,17 +644,10 @@ public:
         return transpose_2d();
     }
 
+    // Equivale a sum(*this, 0) de tensor_reduce.h
     Tensor sum_rows() const {
         if constexpr (Rank == 2) {
-            Tensor result(1, shape_[1]);
-            for (size_t j = 0; j < shape_[1]; ++j) {
-                T sum = 0;
-                for (size_t i = 0; i < shape_[0]; ++i) {
-                    sum += (*this)(i, j);
-                }
-                result(0, j) = sum;
-            }
-            return result;
+            return sum(*this, 0);
         } else {
             throw std::invalid_argument("sum_rows() only works for 2D tensors");
         }
@@ -374,14 +698,74 @@ public:
     }
 };
 
+// Evaluacion perezosa a pedido: lazy(a) + lazy(b) * 2.0 arma una sola expresion y la
+// calcula en un recorrido al asignarla a un Tensor, sin temporales intermedios. Regla de
+// alias: lazy(a) guarda una referencia a `a` (y lazy(std::move(a)) una copia), asi que
+// `auto e = lazy(a) + b;` ve los cambios posteriores de a y queda colgando si a se destruye
+// antes. Para guardar el resultado se declara el Tensor o se llama a eval(). Asignar a un
+// Tensor que tambien es operando es seguro: cada elemento solo lee su propia posicion.
 template<typename T, size_t Rank>
-Tensor<T, Rank> operator+(const T& scalar, const Tensor<T, Rank>& tensor) {
-    return tensor + scalar;
+auto lazy(const Tensor<T, Rank>& tensor) {
+    return TensorOperand<T, Rank, const Tensor<T, Rank>&>(tensor);
 }
 
 template<typename T, size_t Rank>
-Tensor<T, Rank> operator*(const T& scalar, const Tensor<T, Rank>& tensor) {
-    return tensor * scalar;
+auto lazy(Tensor<T, Rank>&& tensor) {
+    return TensorOperand<T, Rank, Tensor<T, Rank>>(std::move(tensor));
+}
+
+template<typename L, typename R, typename = std::enable_if_t<detail::are_compatible_operands_v<L, R>>>
+auto operator+(L&& lhs, R&& rhs) {
+    return detail::finish<detail::any_expression_v<L, R>>(
+        detail::make_binary<std::plus<detail::operand_value_t<L>>>(std::forward<L>(lhs), std::forward<R>(rhs)));
+}
+
+template<typename L, typename R, typename = std::enable_if_t<detail::are_compatible_operands_v<L, R>>>
+auto operator-(L&& lhs, R&& rhs) {
+    return detail::finish<detail::any_expression_v<L, R>>(
+        detail::make_binary<std::minus<detail::operand_value_t<L>>>(std::forward<L>(lhs), std::forward<R>(rhs)));
+}
+
+template<typename L, typename R, typename = std::enable_if_t<detail::are_compatible_operands_v<L, R>>>
+auto operator*(L&& lhs, R&& rhs) {
+    return detail::finish<detail::any_expression_v<L, R>>(
+        detail::make_binary<std::multiplies<detail::operand_value_t<L>>>(std::forward<L>(lhs), std::forward<R>(rhs)));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator+(E&& expr, const detail::operand_value_t<E>& scalar) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::plus<detail::operand_value_t<E>>, false>(std::forward<E>(expr), scalar));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator-(E&& expr, const detail::operand_value_t<E>& scalar) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::minus<detail::operand_value_t<E>>, false>(std::forward<E>(expr), scalar));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator*(E&& expr, const detail::operand_value_t<E>& scalar) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::multiplies<detail::operand_value_t<E>>, false>(std::forward<E>(expr), scalar));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator/(E&& expr, const detail::operand_value_t<E>& scalar) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::divides<detail::operand_value_t<E>>, false>(std::forward<E>(expr), scalar));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator+(const detail::operand_value_t<E>& scalar, E&& expr) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::plus<detail::operand_value_t<E>>, true>(std::forward<E>(expr), scalar));
+}
+
+template<typename E, typename = std::enable_if_t<detail::is_operand_v<E>>>
+auto operator*(const detail::operand_value_t<E>& scalar, E&& expr) {
+    return detail::finish<detail::any_expression_v<E>>(
+        detail::make_scalar<std::multiplies<detail::operand_value_t<E>>, true>(std::forward<E>(expr), scalar));
 }
 
 template<typename T, size_t Rank>
@@ -389,6 +773,88 @@ Tensor<T, Rank> transpose_2d(const Tensor<T, Rank>& tensor) {
     return tensor.transpose_2d();
 }
 
+namespace detail {
+
+// Kernels sobre memoria contigua (row-major); tambien los usa la ejecucion planificada.
+// Cada C[i][j] acumula en el mismo orden (k creciente) que el producto ingenuo.
+
+// C (m x n) = A (m x k) * B (k x n), orden i-k-j para recorrer B y C por filas
+template<typename T>
+void gemm(const T* A, const T* B, T* C, size_t m, size_t k, size_t n) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < m; ++i) {
+        T* c = C + i * n;
+        std::fill(c, c + n, T{});
+        for (size_t p = 0; p < k; ++p) {
+            const T a = A[i * k + p];
+            const T* b = B + p * n;
+            for (size_t j = 0; j < n; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+// C (k x n) = A^T * B, con A (m x k) y B (m x n)
+template<typename T>
+void gemm_tn(const T* A, const T* B, T* C, size_t m, size_t k, size_t n) {
+    #pragma omp parallel for
+    for (size_t p = 0; p < k; ++p) {
+        T* c = C + p * n;
+        std::fill(c, c + n, T{});
+        for (size_t i = 0; i < m; ++i) {
+            const T a = A[i * k + p];
+            const T* b = B + i * n;
+            for (size_t j = 0; j < n; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+// C (m x k) = A * B^T, con A (m x n) y B (k x n)
+template<typename T>
+void gemm_nt(const T* A, const T* B, T* C, size_t m, size_t n, size_t k) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < m; ++i) {
+        const T* a = A + i * n;
+        for (size_t p = 0; p < k; ++p) {
+            const T* b = B + p * n;
+            T sum = T{};
+            for (size_t j = 0; j < n; ++j) {
+                sum += a[j] * b[j];
+            }
+            C[i * k + p] = sum;
+        }
+    }
+}
+
+// batch productos C_b (m x n) = A_b (m x k) * B_b (k x n). Los strides permiten compartir un
+// operando entre lotes (stride 0). Se paraleliza sobre (lote, fila) y cada fila sigue el
+// orden i-k-j de gemm, asi que cada lote da exactamente lo mismo que gemm por separado.
+template<typename T>
+void batched_gemm(const T* A, const T* B, T* C, size_t batch, size_t m, size_t k, size_t n,
+                  size_t stride_a, size_t stride_b) {
+    #pragma omp parallel for collapse(2)
+    for (size_t l = 0; l < batch; ++l) {
+        for (size_t i = 0; i < m; ++i) {
+            const T* a = A + l * stride_a + i * k;
+            const T* b_batch = B + l * stride_b;
+            T* c = C + l * m * n + i * n;
+            std::fill(c, c + n, T{});
+            for (size_t p = 0; p < k; ++p) {
+                const T a_ip = a[p];
+                const T* b = b_batch + p * n;
+                for (size_t j = 0; j < n; ++j) {
+                    c[j] += a_ip * b[j];
+                }
+            }
+        }
+    }
+}
+
+}
+
 template<typename T, size_t Rank>
 Tensor<T, Rank> matrix_product(const Tensor<T, Rank>& a, const Tensor<T, Rank>& b) {
     static_assert(Rank >= 2, "Matrix product requires at least 2D tensors");
@@ -414,28 +880,10 @@ Tensor<T, Rank> matrix_product(const Tensor<T, Rank>& a, const Tensor<T, Rank>&
     Tensor<T, Rank> result(result_shape);
 
     if constexpr (Rank == 2) {
-        #pragma omp parallel for
-        for (size_t i = 0; i < shape_a[0]; ++i) {
-            for (size_t j = 0; j < shape_b[1]; ++j) {
-                T sum = T{};
-                for (size_t k = 0; k < shape_a[1]; ++k) {
-                    sum += a(i, k) * b(k, j);
-                }
-                result(i, j) = sum;
-            }
-        }
+        detail::gemm(a.data(), b.data(), result.data(), shape_a[0], shape_a[1], shape_b[1]);
     } else if constexpr (Rank == 3) {
-        for (size_t batch = 0; batch < shape_a[0]; ++batch) {
-            for (size_t i = 0; i < shape_a[1]; ++i) {
-                for (size_t j = 0; j < shape_b[2]; ++j) {
-                    T sum = T{};
-                    for (size_t k = 0; k < shape_a[2]; ++k) {
-                        sum += a(batch, i, k) * b(batch, k, j);
-                    }
-                    result(batch, i, j) = sum;
-                }
-            }
-        }
+        const size_t m = shape_a[1], k = shape_a[2], n = shape_b[2];
+        detail::batched_gemm(a.data(), b.data(), result.data(), shape_a[0], m, k, n, m * k, k * n);
     }
 
     return result;
@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "tensor.h"
+
+namespace utec {
+namespace algebra {
+
+// Philox4x32-10 (Salmon et al., 2011): generador basado en contador. El valor del bloque
+// n depende solo de (semilla, flujo, n), asi que cualquier elemento se calcula sin estado
+// compartido y el llenado en paralelo da el mismo resultado con cualquier numero de hilos.
+struct Philox4x32 {
+    using Counter = std::array<std::uint32_t, 4>;
+    using Key = std::array<std::uint32_t, 2>;
+
+    static constexpr std::uint32_t kMul0 = 0xD2511F53u;
+    static constexpr std::uint32_t kMul1 = 0xCD9E8D57u;
+    static constexpr std::uint32_t kWeyl0 = 0x9E3779B9u;
+    static constexpr std::uint32_t kWeyl1 = 0xBB67AE85u;
+    static constexpr int kRounds = 10;
+
+    static Counter generate(Counter counter, Key key) {
+        for (int round = 0; round < kRounds; ++round) {
+            if (round > 0) {
+                key[0] += kWeyl0;
+                key[1] += kWeyl1;
+            }
+            const std::uint64_t p0 = std::uint64_t(kMul0) * counter[0];
+            const std::uint64_t p1 = std::uint64_t(kMul1) * counter[2];
+            counter = {std::uint32_t(p1 >> 32) ^ counter[1] ^ key[0], std::uint32_t(p1),
+                       std::uint32_t(p0 >> 32) ^ counter[3] ^ key[1], std::uint32_t(p0)};
+        }
+        return counter;
+    }
+};
+
+// Semilla + numero de flujo: cada llenado usa un flujo distinto de la misma semilla
+struct RandomStream {
+    std::uint64_t seed = 0;
+    std::uint64_t stream = 0;
+
+    Philox4x32::Counter block(std::uint64_t index) const {
+        return Philox4x32::generate(
+            {std::uint32_t(index), std::uint32_t(index >> 32), std::uint32_t(stream), std::uint32_t(stream >> 32)},
+            {std::uint32_t(seed), std::uint32_t(seed >> 32)});
+    }
+};
+
+namespace detail {
+
+constexpr std::uint64_t kDefaultSeed = 0x5EEDu;
+
+inline std::atomic<std::uint64_t>& random_seed() {
+    static std::atomic<std::uint64_t> seed{kDefaultSeed};
+    return seed;
+}
+
+inline std::atomic<std::uint64_t>& random_stream_counter() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter;
+}
+
+// Uniforme en (0, 1) con 53 bits a partir de dos palabras; nunca devuelve 0 (seguro para log)
+inline double to_unit(std::uint32_t high, std::uint32_t low) {
+    const std::uint64_t bits = ((std::uint64_t(high) << 32) | low) >> 11;
+    return (double(bits) + 0.5) * 0x1.0p-53;
+}
+
+}
+
+// Fija la semilla global y reinicia el contador de flujos: la misma secuencia de llamadas
+// produce los mismos tensores en cada ejecucion
+inline void set_global_seed(std::uint64_t seed) {
+    detail::random_seed().store(seed);
+    detail::random_stream_counter().store(0);
+}
+
+inline std::uint64_t global_seed() { return detail::random_seed().load(); }
+
+inline RandomStream next_stream() {
+    return RandomStream{detail::random_seed().load(), detail::random_stream_counter().fetch_add(1)};
+}
+
+// Cada bloque Philox da dos valores: el elemento i sale del bloque i / 2
+template<typename T, size_t Rank>
+void fill_uniform(Tensor<T, Rank>& tensor, T low, T high, RandomStream stream = next_stream()) {
+    T* out = tensor.data();
+    const size_t n = tensor.size();
+    const double width = double(high) - double(low);
+    const size_t blocks = (n + 1) / 2;
+
+    #pragma omp parallel for
+    for (size_t b = 0; b < blocks; ++b) {
+        const auto words = stream.block(b);
+        out[2 * b] = T(double(low) + width * detail::to_unit(words[0], words[1]));
+        if (2 * b + 1 < n) out[2 * b + 1] = T(double(low) + width * detail::to_unit(words[2], words[3]));
+    }
+}
+
+// Box-Muller sobre el par uniforme de cada bloque
+template<typename T, size_t Rank>
+void fill_normal(Tensor<T, Rank>& tensor, T mean, T stddev, RandomStream stream = next_stream()) {
+    constexpr double kTwoPi = 6.283185307179586476925286766559;
+    T* out = tensor.data();
+    const size_t n = tensor.size();
+    const size_t blocks = (n + 1) / 2;
+
+    #pragma omp parallel for
+    for (size_t b = 0; b < blocks; ++b) {
+        const auto words = stream.block(b);
+        const double radius = std::sqrt(-2.0 * std::log(detail::to_unit(words[0], words[1])));
+        const double angle = kTwoPi * detail::to_unit(words[2], words[3]);
+        out[2 * b] = T(double(mean) + double(stddev) * radius * std::cos(angle));
+        if (2 * b + 1 < n) out[2 * b + 1] = T(double(mean) + double(stddev) * radius * std::sin(angle));
+    }
+}
+
+}
+}
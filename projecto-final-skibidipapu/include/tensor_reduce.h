@@ -0,0 +1,370 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace utec {
+namespace algebra {
+
+// Suma compensada (Neumaier): el error de redondeo de cada suma se acumula aparte
+template<typename T>
+class CompensatedSum {
+    T sum_ = T(0);
+    T compensation_ = T(0);
+
+public:
+    void add(T value) {
+        const T total = sum_ + value;
+        if (std::abs(sum_) >= std::abs(value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
+    }
+
+    void add(const CompensatedSum& other) {
+        add(other.sum_);
+        add(other.compensation_);
+    }
+
+    T value() const { return sum_ + compensation_; }
+};
+
+constexpr size_t kReduceLanes = 64;
+constexpr size_t kMinTermsPerLane = 256;
+
+// Suma de term(i) para i en [0, n). El rango se parte en tramos contiguos que dependen
+// solo de n (no del numero de hilos), cada tramo se suma con compensacion en paralelo y
+// los parciales se combinan en orden: el resultado es reproducible y no reserva memoria.
+// term puede escribir en su propia posicion de un buffer de salida.
+template<typename T, typename F>
+T parallel_sum(size_t n, F&& term) {
+    const size_t lanes = std::clamp<size_t>(n / kMinTermsPerLane, 1, kReduceLanes);
+    std::array<CompensatedSum<T>, kReduceLanes> partial{};
+
+    #pragma omp parallel for if(lanes > 1)
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        const size_t begin = n * lane / lanes;
+        const size_t end = n * (lane + 1) / lanes;
+        CompensatedSum<T> sum;
+        for (size_t i = begin; i < end; ++i) {
+            sum.add(term(i));
+        }
+        partial[lane] = sum;
+    }
+
+    CompensatedSum<T> total;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        total.add(partial[lane]);
+    }
+    return total.value();
+}
+
+template<typename T, size_t Rank>
+class Tensor;
+
+namespace detail {
+
+// Filas sumadas sin compensar antes de cada suma compensada, y columnas por bloque en pila
+constexpr size_t kReduceBlockRows = 8;
+constexpr size_t kReduceBlockCols = 256;
+constexpr size_t kParallelReduceWork = size_t(1) << 15;
+constexpr size_t kMinReduceLaneWork = size_t(1) << 13;
+
+// TwoSum de Knuth: sin ramas (a diferencia de CompensatedSum), asi se vectoriza por columnas
+template<typename T>
+inline void two_sum_add(T& sum, T& compensation, T value) {
+    const T total = sum + value;
+    const T rounded = total - sum;
+    compensation += (sum - (total - rounded)) + (value - rounded);
+    sum = total;
+}
+
+// Un tensor visto como outer x n x inner respecto al eje reducido. Con poco trabajo por
+// slice el eje se parte en `lanes` tramos que dependen solo de la forma: el resultado no
+// cambia con el numero de hilos.
+struct AxisLayout {
+    size_t outer = 1, n = 1, inner = 1, lanes = 1;
+
+    size_t work() const { return outer * n * inner; }
+    size_t begin(size_t lane) const { return n * lane / lanes; }
+};
+
+template<size_t Rank>
+AxisLayout axis_layout(const std::array<size_t, Rank>& shape, size_t axis) {
+    if (axis >= Rank) {
+        throw std::invalid_argument("Reduction axis is out of range");
+    }
+    AxisLayout layout;
+    layout.n = shape[axis];
+    for (size_t d = 0; d < axis; ++d) layout.outer *= shape[d];
+    for (size_t d = axis + 1; d < Rank; ++d) layout.inner *= shape[d];
+    if (layout.work() >= kParallelReduceWork && layout.outer < kReduceLanes) {
+        const size_t limit = std::min(kReduceLanes / layout.outer, layout.n);
+        layout.lanes = std::clamp<size_t>(layout.n * layout.inner / kMinReduceLaneWork, 1, limit);
+    }
+    return layout;
+}
+
+template<size_t Rank>
+std::array<size_t, Rank> reduced_shape(std::array<size_t, Rank> shape, size_t axis) {
+    shape[axis] = 1;
+    return shape;
+}
+
+// Suma compensada de `rows` filas de `inner` columnas separadas por `stride` (o de
+// exp(x - shift[j]) si Exp). Se recorre fila a fila: los accesos son contiguos y cada columna
+// lleva su propia suma compensada, asi el bucle interno vectoriza. Con una sola columna
+// contigua se usan 8 sumas parciales intercaladas.
+template<bool Exp, typename T>
+void accumulate_sum(const T* src, size_t rows, size_t inner, size_t stride, const T* shift, T* sum,
+                    T* compensation) {
+    auto term = [&](T value, size_t j) {
+        if constexpr (Exp) return std::exp(value - shift[j]);
+        else return value;
+    };
+    if (inner == 1 && stride == 1) {
+        T s[8] = {}, c[8] = {};
+        size_t i = 0;
+        for (; i + 8 * kReduceBlockRows <= rows; i += 8 * kReduceBlockRows) {
+            T block[8] = {};
+            for (size_t k = 0; k < 8 * kReduceBlockRows; k += 8)
+                for (size_t u = 0; u < 8; ++u) block[u] += term(src[i + k + u], 0);
+            for (size_t u = 0; u < 8; ++u) two_sum_add(s[u], c[u], block[u]);
+        }
+        for (; i + 8 <= rows; i += 8)
+            for (size_t u = 0; u < 8; ++u) two_sum_add(s[u], c[u], term(src[i + u], 0));
+        for (; i < rows; ++i) two_sum_add(s[0], c[0], term(src[i], 0));
+        for (size_t u = 1; u < 8; ++u) {
+            two_sum_add(s[0], c[0], s[u]);
+            c[0] += c[u];
+        }
+        sum[0] = s[0];
+        compensation[0] = c[0];
+        return;
+    }
+    std::fill(sum, sum + inner, T(0));
+    std::fill(compensation, compensation + inner, T(0));
+    // Cada kReduceBlockRows filas se suman sin compensar y el bloque entra a la suma compensada
+    for (size_t j0 = 0; j0 < inner; j0 += kReduceBlockCols) {
+        const size_t width = std::min(kReduceBlockCols, inner - j0);
+        T block[kReduceBlockCols];
+        for (size_t r0 = 0; r0 < rows; r0 += kReduceBlockRows) {
+            const size_t last = std::min(rows, r0 + kReduceBlockRows);
+            const T* first = src + r0 * stride + j0;
+            for (size_t j = 0; j < width; ++j) block[j] = term(first[j], j0 + j);
+            for (size_t r = r0 + 1; r < last; ++r) {
+                const T* row = src + r * stride + j0;
+                for (size_t j = 0; j < width; ++j) block[j] += term(row[j], j0 + j);
+            }
+            for (size_t j = 0; j < width; ++j) two_sum_add(sum[j0 + j], compensation[j0 + j], block[j]);
+        }
+    }
+}
+
+// out[o * inner + j] = scale * suma sobre el eje; shift (outer x inner) solo si Exp.
+// Con un solo tramo por slice (todo tensor con menos de kParallelReduceWork elementos) la
+// suma va directo a out y la compensacion de cada bloque de columnas vive en la pila: no se
+// reserva memoria. Solo los ejes largos partidos en tramos usan un buffer de parciales.
+template<bool Exp = false, typename T>
+void sum_axis(const T* src, const AxisLayout& layout, T* out, T scale = T(1), const T* shift = nullptr) {
+    if (layout.lanes == 1) {
+        #pragma omp parallel for if(layout.outer > 1 && layout.work() >= kParallelReduceWork)
+        for (size_t o = 0; o < layout.outer; ++o) {
+            for (size_t j0 = 0; j0 < layout.inner; j0 += kReduceBlockCols) {
+                const size_t width = std::min(kReduceBlockCols, layout.inner - j0);
+                T compensation[kReduceBlockCols];
+                T* sum = out + o * layout.inner + j0;
+                accumulate_sum<Exp>(src + o * layout.n * layout.inner + j0, layout.n, width, layout.inner,
+                                    shift ? shift + o * layout.inner + j0 : nullptr, sum, compensation);
+                for (size_t j = 0; j < width; ++j) sum[j] = (sum[j] + compensation[j]) * scale;
+            }
+        }
+        return;
+    }
+    const size_t width = layout.outer * layout.inner;
+    std::vector<T> partial(2 * layout.lanes * width);
+    T* sums = partial.data();
+    T* compensations = sums + layout.lanes * width;
+    const size_t tasks = layout.outer * layout.lanes;
+
+    #pragma omp parallel for if(tasks > 1 && layout.work() >= kParallelReduceWork)
+    for (size_t task = 0; task < tasks; ++task) {
+        const size_t o = task / layout.lanes, lane = task % layout.lanes;
+        const size_t first = layout.begin(lane), last = layout.begin(lane + 1);
+        const size_t offset = lane * width + o * layout.inner;
+        accumulate_sum<Exp>(src + (o * layout.n + first) * layout.inner, last - first, layout.inner, layout.inner,
+                            shift ? shift + o * layout.inner : nullptr, sums + offset, compensations + offset);
+    }
+
+    for (size_t idx = 0; idx < width; ++idx) {
+        T s = sums[idx], c = compensations[idx];
+        for (size_t lane = 1; lane < layout.lanes; ++lane) {
+            two_sum_add(s, c, sums[lane * width + idx]);
+            c += compensations[lane * width + idx];
+        }
+        out[idx] = (s + c) * scale;
+    }
+}
+
+// Suma por columnas de una matriz rows x cols contigua; sin reservar memoria mientras
+// rows * cols < kParallelReduceWork
+template<typename T>
+void sum_columns(const T* src, size_t rows, size_t cols, T* out) {
+    sum_axis(src, axis_layout(std::array<size_t, 2>{rows, cols}, 0), out);
+}
+
+// Extremo (Better = greater para max, less para min) sobre el eje; ante empates gana el
+// primer indice. index puede ser nulo.
+template<typename T, typename Better>
+void extreme_rows(const T* src, size_t rows, size_t inner, T* best, size_t* index, size_t base, Better better) {
+    if (inner == 1) {
+        // Acumuladores independientes (vectorizables) y luego la primera posicion del extremo
+        T acc[8];
+        for (size_t u = 0; u < 8; ++u) acc[u] = src[0];
+        size_t i = 0;
+        for (; i + 8 <= rows; i += 8)
+            for (size_t u = 0; u < 8; ++u) acc[u] = better(src[i + u], acc[u]) ? src[i + u] : acc[u];
+        T value = acc[0];
+        for (size_t u = 1; u < 8; ++u) value = better(acc[u], value) ? acc[u] : value;
+        for (; i < rows; ++i) value = better(src[i], value) ? src[i] : value;
+        best[0] = value;
+        if (index) {
+            size_t at = 0;
+            while (at < rows && src[at] != value) ++at;
+            index[0] = base + (at < rows ? at : 0);
+        }
+        return;
+    }
+    std::copy(src, src + inner, best);
+    if (index) std::fill(index, index + inner, base);
+    for (size_t r = 1; r < rows; ++r) {
+        const T* row = src + r * inner;
+        if (index) {
+            for (size_t j = 0; j < inner; ++j) {
+                const bool take = better(row[j], best[j]);
+                best[j] = take ? row[j] : best[j];
+                index[j] = take ? base + r : index[j];
+            }
+        } else {
+            for (size_t j = 0; j < inner; ++j) best[j] = better(row[j], best[j]) ? row[j] : best[j];
+        }
+    }
+}
+
+template<typename T, typename Better>
+void extreme_axis(const T* src, const AxisLayout& layout, T* out, size_t* index, Better better) {
+    if (layout.n == 0) {
+        throw std::invalid_argument("Cannot reduce an empty axis");
+    }
+    if (layout.lanes == 1) {
+        // Sin parciales: cada slice escribe su extremo directo en out
+        #pragma omp parallel for if(layout.outer > 1 && layout.work() >= kParallelReduceWork)
+        for (size_t o = 0; o < layout.outer; ++o)
+            extreme_rows(src + o * layout.n * layout.inner, layout.n, layout.inner, out + o * layout.inner,
+                         index ? index + o * layout.inner : nullptr, 0, better);
+        return;
+    }
+    const size_t width = layout.outer * layout.inner;
+    std::vector<T> values(layout.lanes * width);
+    std::vector<size_t> positions(index ? layout.lanes * width : 0);
+    const size_t tasks = layout.outer * layout.lanes;
+
+    #pragma omp parallel for if(tasks > 1 && layout.work() >= kParallelReduceWork)
+    for (size_t task = 0; task < tasks; ++task) {
+        const size_t o = task / layout.lanes, lane = task % layout.lanes;
+        const size_t first = layout.begin(lane), last = layout.begin(lane + 1);
+        const size_t offset = lane * width + o * layout.inner;
+        extreme_rows(src + (o * layout.n + first) * layout.inner, last - first, layout.inner,
+                     values.data() + offset, index ? positions.data() + offset : nullptr, first, better);
+    }
+
+    for (size_t idx = 0; idx < width; ++idx) {
+        T value = values[idx];
+        size_t at = index ? positions[idx] : 0;
+        for (size_t lane = 1; lane < layout.lanes; ++lane) {
+            if (better(values[lane * width + idx], value)) {
+                value = values[lane * width + idx];
+                if (index) at = positions[lane * width + idx];
+            }
+        }
+        out[idx] = value;
+        if (index) index[idx] = at;
+    }
+}
+
+}
+
+// Reducciones sobre un eje de cualquier rango. El eje reducido queda con tamano 1, asi el
+// resultado se combina por broadcasting con el tensor original.
+template<typename T, size_t Rank>
+Tensor<T, Rank> sum(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    Tensor<T, Rank> result(detail::reduced_shape(tensor.shape(), axis));
+    detail::sum_axis(tensor.data(), layout, result.data());
+    return result;
+}
+
+template<typename T, size_t Rank>
+Tensor<T, Rank> mean(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    if (layout.n == 0) {
+        throw std::invalid_argument("Cannot reduce an empty axis");
+    }
+    Tensor<T, Rank> result(detail::reduced_shape(tensor.shape(), axis));
+    detail::sum_axis(tensor.data(), layout, result.data(), T(1) / T(layout.n));
+    return result;
+}
+
+template<typename T, size_t Rank>
+Tensor<T, Rank> amax(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    Tensor<T, Rank> result(detail::reduced_shape(tensor.shape(), axis));
+    detail::extreme_axis(tensor.data(), layout, result.data(), nullptr, std::greater<T>());
+    return result;
+}
+
+template<typename T, size_t Rank>
+Tensor<T, Rank> amin(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    Tensor<T, Rank> result(detail::reduced_shape(tensor.shape(), axis));
+    detail::extreme_axis(tensor.data(), layout, result.data(), nullptr, std::less<T>());
+    return result;
+}
+
+// Posicion del maximo a lo largo del eje (la primera ante empates)
+template<typename T, size_t Rank>
+Tensor<size_t, Rank> argmax(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    const auto shape = detail::reduced_shape(tensor.shape(), axis);
+    std::vector<T> values(layout.outer * layout.inner);
+    Tensor<size_t, Rank> result(shape);
+    detail::extreme_axis(tensor.data(), layout, values.data(), result.data(), std::greater<T>());
+    return result;
+}
+
+// log(sum(exp(x))) estable: se resta el maximo antes de exponenciar
+template<typename T, size_t Rank>
+Tensor<T, Rank> logsumexp(const Tensor<T, Rank>& tensor, size_t axis) {
+    const auto layout = detail::axis_layout(tensor.shape(), axis);
+    Tensor<T, Rank> peak = amax(tensor, axis);
+    Tensor<T, Rank> result(peak.shape());
+    detail::sum_axis<true>(tensor.data(), layout, result.data(), T(1), peak.data());
+    for (size_t i = 0; i < result.size(); ++i) {
+        // Todo -inf (o algun +inf / NaN): el maximo ya es la respuesta
+        result[i] = std::isfinite(peak[i]) ? peak[i] + std::log(result[i]) : peak[i];
+    }
+    return result;
+}
+
+}
+}
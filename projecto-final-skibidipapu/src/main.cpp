@@ -1,14 +1,19 @@
 #include <iostream>
-#include <random>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
 #include "../include/tensor.h"
+#include "../include/tensor_random.h"
 #include "../include/nn_interfaces.h"
 #include "../include/nn_activation.h"
 #include "../include/nn_dense.h"
 #include "../include/nn_loss.h"
 #include "../include/nn_optimizer.h"
 #include "../include/neural_network.h"
+#include "../include/nn_training.h"
+#include "../include/nn_sweep.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -19,17 +24,14 @@ using namespace std;
 
 template<typename T>
 class RandomInitializer {
-    mt19937 gen_;
-    normal_distribution<T> dist_;
+    T mean_, stddev_;
     
 public:
     RandomInitializer(T mean = 0.0, T stddev = 0.1) 
-        : gen_(random_device{}()), dist_(mean, stddev) {}
+        : mean_(mean), stddev_(stddev) {}
     
     void operator()(Tensor<T, 2>& tensor) {
-        for (size_t i = 0; i < tensor.size(); ++i) {
-            tensor[i] = dist_(gen_);
-        }
+        fill_normal(tensor, mean_, stddev_);
     }
 };
 
@@ -43,18 +45,17 @@ public:
 
 template<typename T>
 pair<Tensor<T, 2>, Tensor<T, 2>> generate_xor_data(size_t num_samples = 10000) {
-    mt19937 gen(random_device{}());
-    uniform_real_distribution<T> dist(-0.1, 0.1);
-    
     Tensor<T, 2> X(num_samples, 2);
     Tensor<T, 2> Y(num_samples, 1);
+    fill_uniform(X, T(-0.1), T(0.1));
     
+    #pragma omp parallel for
     for (size_t i = 0; i < num_samples; ++i) {
         T x1 = (i % 4 < 2) ? T(0) : T(1);
         T x2 = (i % 2 == 0) ? T(0) : T(1);
         
-        X(i, 0) = x1 + dist(gen);
-        X(i, 1) = x2 + dist(gen);
+        X(i, 0) += x1;
+        X(i, 1) += x2;
         
         Y(i, 0) = (x1 != x2) ? T(1) : T(0);
     }
@@ -64,21 +65,76 @@ pair<Tensor<T, 2>, Tensor<T, 2>> generate_xor_data(size_t num_samples = 10000) {
 
 template<typename T>
 class PerformanceMonitor {
-    chrono::high_resolution_clock::time_point start_;
+    chrono::steady_clock::time_point start_;
     
 public:
     void start() {
-        start_ = chrono::high_resolution_clock::now();
+        start_ = chrono::steady_clock::now();
     }
     
     T elapsed_seconds() {
-        auto end = chrono::high_resolution_clock::now();
-        auto duration = chrono::duration_cast<chrono::milliseconds>(end - start_);
-        return T(duration.count()) / T(1000.0);
+        auto end = chrono::steady_clock::now();
+        return chrono::duration<T>(end - start_).count();
     }
 };
 
-int main() {
+// Busqueda de hiperparametros sobre el mismo problema XOR (--sweep): una configuracion por
+// nucleo y successive halving; el resumen queda en sweep_results.csv / sweep_results.json
+int run_sweep() {
+    using T = double;
+    set_global_seed(2025);
+    auto [X_train, y_train] = generate_xor_data<T>(5000);
+    auto [X_val, y_val] = generate_xor_data<T>(1000);
+
+    SweepSpace<T> space;
+    space.batch_sizes = {32, 128};
+    space.learning_rates = {0.003, 0.01, 0.03};
+    space.hidden_widths = {16, 64};
+    const auto configs = space.grid();
+
+    SweepOptions options;
+    options.min_epochs = 5;
+    options.max_epochs = 45;
+    options.eta = 3;
+    HyperparameterSweep<T, BCELoss, SGD> sweep([](NeuralNetwork<T>& network, const SweepConfig<T>& config) {
+        RandomInitializer<T> weight_init(0.0, 0.1);
+        ZeroInitializer<T> bias_init;
+        network.add_layer(std::make_unique<Dense<T>>(2, config.hidden, weight_init, bias_init));
+        network.add_layer(std::make_unique<ReLU<T>>());
+        network.add_layer(std::make_unique<Dense<T>>(config.hidden, config.hidden, weight_init, bias_init));
+        network.add_layer(std::make_unique<ReLU<T>>());
+        network.add_layer(std::make_unique<Dense<T>>(config.hidden, 1, weight_init, bias_init));
+        network.add_layer(std::make_unique<Sigmoid<T>>());
+    }, options);
+
+    cout << "=== Busqueda de hiperparametros (" << configs.size() << " configuraciones) ===" << '\n';
+    PerformanceMonitor<T> monitor;
+    monitor.start();
+    const auto results = sweep.run(configs, X_train, y_train, X_val, y_val);
+    cout << "   Tiempo total: " << monitor.elapsed_seconds() << " segundos" << '\n';
+
+    const auto& best = results.front();
+    cout << "   Mejor: batch " << best.config.batch_size << ", lr " << best.config.learning_rate
+         << ", ancho " << best.config.hidden << " -> val_loss " << best.val_loss
+         << ", precision " << best.val_accuracy * T(100) << "%" << '\n';
+
+    ofstream csv("sweep_results.csv");
+    write_sweep_csv(csv, results);
+    ofstream json("sweep_results.json");
+    write_sweep_json(json, results);
+    cout << "   Resultados guardados en sweep_results.csv y sweep_results.json" << '\n';
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--sweep") {
+        try {
+            return run_sweep();
+        } catch (const exception& e) {
+            cerr << "Error durante la busqueda: " << e.what() << '\n';
+            return 1;
+        }
+    }
 #ifdef _OPENMP
     cout << "OpenMP ACTIVO. Numero de hilos disponibles: " << omp_get_max_threads() << '\n';
 #else
@@ -91,6 +147,10 @@ int main() {
     using T = double;
     
     try {
+        // Misma semilla, mismos datos y pesos en cada ejecucion (con cualquier numero de hilos)
+        set_global_seed(2025);
+        cout << "Semilla global: " << global_seed() << '\n';
+
         cout << "\n1. Generando datos de entrenamiento (problema XOR)..." << '\n';
         // Cambios para optimizar velocidad de entrenamiento
         const size_t epochs = 500;
@@ -103,6 +163,8 @@ int main() {
         cout << "   X_train shape: [" << X_train.shape()[0] << ", " << X_train.shape()[1] << "]" << '\n';
         cout << "   y_train shape: [" << y_train.shape()[0] << ", " << y_train.shape()[1] << "]" << '\n';
         
+        // Validacion para EarlyStopping; el test solo se usa en la evaluacion final
+        auto [X_val, y_val] = generate_xor_data<T>(1000);
         auto [X_test, y_test] = generate_xor_data<T>(1000);
         
         cout << "\n2. Configurando arquitectura de red neuronal..." << '\n';
@@ -133,30 +195,47 @@ int main() {
         cout << "   Tamano de batch: " << batch_size << '\n';
         cout << "   Learning rate: " << learning_rate << '\n';
         
+#ifdef UTEC_NN_PROFILING
+        Profiler<T> profiler;
+        network.set_profiler(&profiler);
+#endif
+
         PerformanceMonitor<T> monitor;
         monitor.start();
         
-        network.train<BCELoss, SGD>(X_train, y_train, epochs, batch_size, learning_rate);
+        // Metricas acumuladas durante el entrenamiento; la validacion corre en otro hilo
+        Trainer<T, BCELoss, SGD> trainer(network);
+        trainer.validate_on(X_val, y_val);
+        trainer.emplace_callback<ProgressLogger<T>>(cout, 50);
+        trainer.emplace_callback<EarlyStopping<T>>(25, T(1e-5));
+        const auto& history = trainer.fit(X_train, y_train, epochs, batch_size, learning_rate);
         
         T training_time = monitor.elapsed_seconds();
         cout << "   Tiempo de entrenamiento: " << training_time << " segundos" << '\n';
+
+#ifdef UTEC_NN_PROFILING
+        if (!profiler.epochs().empty()) {
+            Profiler<T>::print_profile(cout, profiler.epochs().back(), "   Perfil de la ultima epoca");
+        }
+        ofstream trace("training_trace.json");
+        profiler.write_chrome_trace(trace);
+        cout << "   Traza guardada en training_trace.json (chrome://tracing)" << '\n';
+        network.set_profiler(nullptr);
+#endif
         
         cout << "\n4. Evaluando rendimiento..." << '\n';
         
-        auto predictions = network.predict(X_test);
-        
-        size_t correct = 0;
-        for (size_t i = 0; i < y_test.shape()[0]; ++i) {
-            T pred = predictions(i, 0) > 0.5 ? T(1) : T(0);
-            T true_val = y_test(i, 0);
-            if (pred == true_val) {
-                correct++;
-            }
-        }
-        
-        T accuracy = T(correct) / T(y_test.shape()[0]) * T(100.0);
+        MetricAccumulator<T> test_metrics;
+        const auto test_output = network.predict(X_test);
+        BCELoss<T> test_loss(test_output, y_test);
+        test_metrics.add_batch(test_output, y_test, test_loss.loss());
+        T accuracy = test_metrics.accuracy() * T(100.0);
+        size_t correct = size_t(std::lround(test_metrics.accuracy() * T(y_test.shape()[0])));
         
+        cout << "   Epocas entrenadas: " << history.size() << '\n';
+        cout << "   Precision en validacion (ultima epoca): " << history.back().val_accuracy * T(100.0) << "%" << '\n';
         cout << "   Precision en test: " << accuracy << "%" << '\n';
+        cout << "   AUC en test: " << test_metrics.auc() << '\n';
         cout << "   Muestras correctas: " << correct << "/" << y_test.shape()[0] << '\n';
         
         cout << "\n5. Demostracion XOR:" << '\n';
@@ -178,6 +257,7 @@ int main() {
                       << expected << "\t\t" << predicted << '\n';
         }
         // Imprimir 20 ejemplos de prediccion del test
+        auto predictions = network.predict(utec::neural_network::detail::slice_rows(X_test, 0, 20));
         cout << "\nEjemplos de prediccion en el test:" << '\n';
         for (size_t i = 0; i < 20; ++i) {
             cout << "   Entrada: [" << X_test(i, 0) << ", " << X_test(i, 1) << "]\t"
@@ -186,7 +266,7 @@ int main() {
         
         cout << "\n6. Metricas de rendimiento:" << '\n';
         cout << "   Tiempo total: " << training_time << " segundos" << '\n';
-        cout << "   Epocas por segundo: " << T(epochs) / training_time << '\n';
+        cout << "   Epocas por segundo: " << T(history.size()) / training_time << '\n';
         cout << "   Precision final: " << accuracy << "%" << '\n';
         
         cout << "\n7. Informacion del sistema:" << '\n';
@@ -0,0 +1,77 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_COUNTING_NEW_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_COUNTING_NEW_H
+
+// Reemplaza el operator new / delete global para contar toda reserva del programa
+// (Tensor, std::vector, std::function, shared_ptr...), no solo la de los tensores.
+// Define funciones de reemplazo (no pueden ser inline): incluir en un solo .cpp por ejecutable.
+// Se reemplazan todas las variantes (nothrow y alineadas) para que cada bloque se libere con
+// la funcion que corresponde a su reserva, tambien bajo -fsanitize=address.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace utec_test {
+
+    inline std::atomic<std::size_t> heap_allocation_count{0};
+
+    inline std::size_t heap_allocations() { return heap_allocation_count.load(std::memory_order_relaxed); }
+
+    inline void* counted_malloc(std::size_t size) noexcept {
+        heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+
+    // aligned_alloc pide un tamano multiplo de la alineacion
+    inline void* counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept {
+        heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t align = static_cast<std::size_t>(alignment);
+        const std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded);
+    }
+
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = utec_test::counted_malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return utec_test::counted_malloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return utec_test::counted_malloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = utec_test::counted_aligned_malloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return utec_test::counted_aligned_malloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return utec_test::counted_aligned_malloc(size, alignment);
+}
+
+// GCC no sabe que estos operator new usan malloc y avisa de un free "no emparejado"
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_COUNTING_NEW_H
@@ -0,0 +1,98 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "../include/neural_network.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    void build(NeuralNetwork<double>& net) {
+        auto init_w = [](Tensor<double, 2>& w) {
+            for (size_t i = 0; i < w.size(); ++i) w[i] = 0.05 * double(int(i % 13) - 6);
+        };
+        auto init_b = [](Tensor<double, 2>& b) { b.fill(0.01); };
+        net.add_layer(std::make_unique<Dense<double>>(4, 32, init_w, init_b));
+        for (int block = 0; block < 3; ++block) {
+            net.add_relu_layer();
+            net.add_layer(std::make_unique<Dense<double>>(32, 32, init_w, init_b));
+        }
+        net.add_sigmoid_layer();
+        net.add_layer(std::make_unique<Dense<double>>(32, 1, init_w, init_b));
+        net.add_sigmoid_layer();
+    }
+
+}
+
+int main() {
+    std::cout << "Testing gradient checkpointing..." << std::endl;
+
+    const size_t samples = 64, batch = 16;
+    Tensor<double, 2> X(samples, 4), Y(samples, 1);
+    for (size_t i = 0; i < samples; ++i) {
+        for (size_t j = 0; j < 4; ++j) X(i, j) = double((i * 7 + j * 3) % 10) / 10.0;
+        Y(i, 0) = double(i % 3 == 0);
+    }
+
+    NeuralNetwork<double> plain, checkpointed;
+    build(plain);
+    build(checkpointed);
+    checkpointed.checkpoint_every(3);
+    assert(checkpointed.checkpoint_segments().size() == 3);
+
+    auto estimate = checkpointed.estimate_memory(batch, 4);
+    assert(estimate.activation_bytes < estimate.baseline_bytes);
+    assert(estimate.extra_compute > 0.0 && estimate.extra_compute < 1.0 / 3.0);
+    assert(plain.estimate_memory(batch, 4).extra_compute == 0.0);
+    assert(checkpointed.max_batch_size(estimate.activation_bytes, 4) == batch);
+    assert(checkpointed.max_batch_size(estimate.activation_bytes - 1, 4) == batch - 1);
+
+    // La mascara de ReLU ocupa 2 bits por fila de 32 columnas: una fila sola redondea a una
+    // palabra entera, asi que el presupuesto no se puede repartir por la estimacion de 1 fila
+    NeuralNetwork<double> wide;
+    wide.add_dense_layer(4, 32);
+    wide.add_relu_layer();
+    const size_t budget = wide.estimate_memory(256, 4).activation_bytes;
+    assert(budget == 256 * 4 * sizeof(double) + 256 * 32 / 64 * sizeof(std::uint64_t));
+    assert(wide.max_batch_size(budget, 4) == 256);
+    assert(budget / wide.estimate_memory(1, 4).activation_bytes < 256);
+
+    // Recalcular las activaciones no cambia los gradientes
+    plain.train<BCELoss, SGD>(X, Y, 2, batch, 0.1);
+    checkpointed.train<BCELoss, SGD>(X, Y, 2, batch, 0.1);
+    auto expected = plain.predict(X);
+    auto got = checkpointed.predict(X);
+    for (size_t i = 0; i < expected.size(); ++i)
+        assert(expected[i] == got[i]);
+
+    assert(checkpointed.measured_peak_bytes() < plain.measured_peak_bytes());
+    assert(checkpointed.measured_peak_bytes() <= estimate.activation_bytes);
+    assert(plain.measured_peak_bytes() == plain.estimate_memory(batch, 4).baseline_bytes);
+
+    // Estimar no ejecuta forward: las activaciones guardadas para backward siguen intactas
+    Tensor<double, 2> activation = X;
+    for (const auto& layer : plain.layers()) activation = layer->forward(activation);
+    size_t cached = 0;
+    for (const auto& layer : plain.layers()) cached += layer->cache_bytes();
+    assert(cached == plain.estimate_memory(samples, 4).baseline_bytes);
+    plain.estimate_memory(batch, 4);
+    plain.max_batch_size(1 << 20, 4);
+    size_t after = 0;
+    for (const auto& layer : plain.layers()) after += layer->cache_bytes();
+    assert(after == cached);
+    for (size_t i = plain.layers().size(); i-- > 0;) activation = plain.layers()[i]->backward(activation);
+
+    bool thrown = false;
+    try {
+        checkpointed.checkpoint_segment(1, 4);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All checkpointing tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,222 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <array>
+#include "../include/nn_conv.h"
+#include "../include/neural_network.h"
+#include "../include/tensor_random.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    template<typename F>
+    void with_threads(int threads, F&& body) {
+#ifdef _OPENMP
+        const int previous = omp_get_max_threads();
+        omp_set_num_threads(threads);
+        body();
+        omp_set_num_threads(previous);
+#else
+        (void)threads;
+        body();
+#endif
+    }
+
+    // Convolucion directa (definicion) para comparar con im2col + GEMM
+    Tensor<double, 4> direct_conv(const Tensor<double, 4>& x, const Tensor<double, 2>& W, const Tensor<double, 2>& b,
+                                  size_t out_channels, size_t k, size_t stride, size_t pad) {
+        const auto& s = x.shape();
+        const size_t oh = (s[2] + 2 * pad - k) / stride + 1, ow = (s[3] + 2 * pad - k) / stride + 1;
+        Tensor<double, 4> y(s[0], out_channels, oh, ow);
+        for (size_t n = 0; n < s[0]; ++n)
+            for (size_t o = 0; o < out_channels; ++o)
+                for (size_t oy = 0; oy < oh; ++oy)
+                    for (size_t ox = 0; ox < ow; ++ox) {
+                        double acc = b[o];
+                        for (size_t c = 0; c < s[1]; ++c)
+                            for (size_t ky = 0; ky < k; ++ky)
+                                for (size_t kx = 0; kx < k; ++kx) {
+                                    const long iy = long(oy * stride + ky) - long(pad);
+                                    const long ix = long(ox * stride + kx) - long(pad);
+                                    if (iy < 0 || ix < 0 || iy >= long(s[2]) || ix >= long(s[3])) continue;
+                                    acc += W(o, (c * k + ky) * k + kx) * x(n, c, size_t(iy), size_t(ix));
+                                }
+                        y(n, o, oy, ox) = acc;
+                    }
+        return y;
+    }
+
+    // Perdida escalar sum(Y * R): su gradiente respecto de Y es R
+    double probe_loss(ILayer<double>& layer, const Tensor<double, 2>& X, const Tensor<double, 2>& R) {
+        const auto Y = layer.forward(X);
+        double loss = 0;
+        for (size_t i = 0; i < Y.size(); ++i) loss += Y[i] * R[i];
+        return loss;
+    }
+
+    void check_input_gradient(ILayer<double>& layer, Tensor<double, 2> X, const Tensor<double, 2>& R) {
+        layer.forward(X);
+        const auto dX = layer.backward(R);
+        const double h = 1e-6;
+        for (size_t i = 0; i < X.size(); i += 3) {
+            const double saved = X[i];
+            X[i] = saved + h;
+            const double up = probe_loss(layer, X, R);
+            X[i] = saved - h;
+            const double down = probe_loss(layer, X, R);
+            X[i] = saved;
+            assert(std::fabs((up - down) / (2 * h) - dX[i]) < 1e-6);
+        }
+    }
+
+}
+
+int main() {
+    std::cout << "Testing convolution layers..." << std::endl;
+
+    const ImageShape image{2, 5, 6};
+    Tensor<double, 4> x(3, 2, 5, 6);
+    fill_uniform(x, -1.0, 1.0, RandomStream{1, 0});
+    const auto rows = flatten_images(x);
+    assert(rows.shape()[0] == 3 && rows.shape()[1] == image.size());
+    const auto back = to_images(rows, image);
+    for (size_t i = 0; i < x.size(); ++i) assert(back[i] == x[i]);
+
+    // im2col + GEMM coincide con la definicion, con padding y stride
+    for (auto [k, stride, pad] : {std::array<size_t, 3>{3, 1, 1}, {3, 2, 1}, {2, 1, 0}, {5, 2, 2}}) {
+        set_global_seed(3);
+        Conv2D<double> conv(image, 4, k, stride, pad);
+        conv.release_cache();
+        const auto y = to_images(conv.forward(rows), conv.output_shape());
+        const auto expected = direct_conv(x, conv.weights(), conv.bias(), 4, k, stride, pad);
+        assert(y.shape() == expected.shape());
+        for (size_t i = 0; i < y.size(); ++i) assert(std::fabs(y[i] - expected[i]) < 1e-12);
+    }
+
+    // Gradientes contra diferencias finitas
+    Conv2D<double> conv(image, 3, 3, 2, 1);
+    Tensor<double, 2> R(3, conv.output_shape().size());
+    fill_uniform(R, -1.0, 1.0, RandomStream{2, 0});
+    check_input_gradient(conv, rows, R);
+
+    // El gradiente de W se lee a traves de un paso de SGD: W' = W - lr * dW
+    const auto W = conv.weights();
+    conv.forward(rows);
+    conv.backward(R);
+    SGD<double> sgd(1.0);
+    conv.update_params(sgd);
+    const auto W_next = conv.weights();
+    for (size_t i = 0; i < W.size(); i += 5) {
+        const double h = 1e-6;
+        auto perturbed = [&](double delta) {
+            Conv2D<double> copy(image, 3, 3, 2, 1,
+                                [&](Tensor<double, 2>& w) { w = W; w[i] += delta; },
+                                [&](Tensor<double, 2>& b) { b.fill(0.0); });
+            return probe_loss(copy, rows, R);
+        };
+        const double numeric = (perturbed(h) - perturbed(-h)) / (2 * h);
+        assert(std::fabs(numeric - (W[i] - W_next[i])) < 1e-6);
+    }
+
+    // Max pooling: ventanas disjuntas y solapadas
+    for (size_t stride : {2, 1}) {
+        MaxPool2D<double> pool(image, 2, stride);
+        const auto y = to_images(pool.forward(rows), pool.output_shape());
+        for (size_t n = 0; n < 3; ++n)
+            for (size_t c = 0; c < 2; ++c)
+                for (size_t oy = 0; oy < pool.output_shape().height; ++oy)
+                    for (size_t ox = 0; ox < pool.output_shape().width; ++ox) {
+                        double best = -1e300;
+                        for (size_t ky = 0; ky < 2; ++ky)
+                            for (size_t kx = 0; kx < 2; ++kx)
+                                best = std::max(best, x(n, c, oy * stride + ky, ox * stride + kx));
+                        assert(y(n, c, oy, ox) == best);
+                    }
+        Tensor<double, 2> G(3, pool.output_shape().size());
+        fill_uniform(G, -1.0, 1.0, RandomStream{4, stride});
+        check_input_gradient(pool, rows, G);
+    }
+
+    // Una red pequena con convolucion aprende a separar dos patrones
+    set_global_seed(5);
+    NeuralNetwork<double> net;
+    net.add_layer(std::make_unique<Conv2D<double>>(ImageShape{1, 6, 6}, 4, 3, 1, 1));
+    net.add_relu_layer();
+    net.add_layer(std::make_unique<MaxPool2D<double>>(ImageShape{4, 6, 6}, 2));
+    net.add_layer(std::make_unique<Dense<double>>(4 * 3 * 3, 1));
+    net.add_sigmoid_layer();
+    Tensor<double, 2> images(32, 36), labels(32, 1);
+    fill_uniform(images, 0.0, 0.2, RandomStream{6, 0});
+    for (size_t n = 0; n < 32; ++n) {
+        const bool vertical = n % 2 == 0;
+        for (size_t i = 0; i < 6; ++i) images(n, vertical ? i * 6 + 2 : 2 * 6 + i) += 1.0;
+        labels(n, 0) = vertical ? 1.0 : 0.0;
+    }
+    SGD<double> optimizer(0.5);
+    const double first = net.train_epoch<BCELoss>(images, labels, 8, optimizer);
+    double last = first;
+    for (size_t epoch = 1; epoch < 30; ++epoch) last = net.train_epoch<BCELoss>(images, labels, 8, optimizer, epoch);
+    assert(last < 0.5 * first);
+
+    // Los tramos de gradiente fijos dan los mismos bits con 1 y con 4 hilos (40 filas: mas
+    // filas que tramos, repartidas de forma desigual)
+    {
+        Tensor<double, 2> x(40, 2 * 7 * 7);
+        fill_uniform(x, -1.0, 1.0, RandomStream{10, 0});
+        auto run = [&](int threads, Tensor<double, 2>& y, Tensor<double, 2>& dx, Tensor<double, 2>& W,
+                       Tensor<double, 2>& b) {
+            set_global_seed(11);
+            Conv2D<double> layer(ImageShape{2, 7, 7}, 3, 3, 2, 1);
+            Tensor<double, 2> dy(40, layer.output_shape().size());
+            fill_uniform(dy, -1.0, 1.0, RandomStream{10, 1});
+            with_threads(threads, [&] {
+                y = layer.forward(x);
+                dx = layer.backward(dy);
+                SGD<double> step(1.0);
+                layer.update_params(step);
+            });
+            W = layer.weights();
+            b = layer.bias();
+        };
+        Tensor<double, 2> y1, dx1, W1, b1, y4, dx4, W4, b4;
+        run(1, y1, dx1, W1, b1);
+        run(4, y4, dx4, W4, b4);
+        for (size_t i = 0; i < y1.size(); ++i) assert(y1[i] == y4[i]);
+        for (size_t i = 0; i < dx1.size(); ++i) assert(dx1[i] == dx4[i]);
+        for (size_t i = 0; i < W1.size(); ++i) assert(W1[i] == W4[i]);
+        for (size_t i = 0; i < b1.size(); ++i) assert(b1[i] == b4[i]);
+    }
+
+    // Batch vacio: gradientes en cero y la actualizacion no mueve los filtros
+    {
+        Conv2D<double> conv(ImageShape{1, 4, 4}, 2, 3, 1, 1);
+        Tensor<double, 2> x(2, 16), dy(2, conv.output_shape().size());
+        fill_uniform(x, -1.0, 1.0, RandomStream{8, 0});
+        fill_uniform(dy, -1.0, 1.0, RandomStream{8, 1});
+        conv.forward(x);
+        conv.backward(dy);
+        const Tensor<double, 2> W = conv.weights(), b = conv.bias();
+        conv.backward_planned(x.data(), nullptr, dy.data(), nullptr, 0, 16);
+        SGD<double> sgd(1.0);
+        conv.update_params(sgd);
+        for (size_t i = 0; i < W.size(); ++i) assert(conv.weights()[i] == W[i]);
+        for (size_t i = 0; i < b.size(); ++i) assert(conv.bias()[i] == b[i]);
+    }
+
+    bool thrown = false;
+    try {
+        Conv2D<double> bad(ImageShape{1, 2, 2}, 1, 3);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All convolution tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../include/nn_distributed.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    constexpr int kWorld = 3;
+    constexpr size_t kShardRows = 96, kBatch = 16;
+
+    // Lanza un proceso por rango y espera que todos terminen bien
+    void spawn(const std::function<void(int)>& body) {
+        pid_t children[kWorld];
+        for (int rank = 0; rank < kWorld; ++rank) {
+            children[rank] = ::fork();
+            assert(children[rank] >= 0);
+            if (children[rank] == 0) {
+                ::alarm(60);
+                int code = 0;
+                try {
+                    body(rank);
+                } catch (const std::exception& e) {
+                    std::cerr << "rank " << rank << ": " << e.what() << std::endl;
+                    code = 1;
+                }
+                ::_exit(code);
+            }
+        }
+        for (pid_t child : children) {
+            int status = 0;
+            ::waitpid(child, &status, 0);
+            assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+    }
+
+    void build(NeuralNetwork<double>& net, uint64_t seed) {
+        set_global_seed(seed);
+        net.add_layer(std::make_unique<Dense<double>>(2, 12));
+        net.add_relu_layer();
+        net.add_layer(std::make_unique<Dense<double>>(12, 1));
+        net.add_sigmoid_layer();
+    }
+
+    void xor_data(Tensor<double, 2>& X, Tensor<double, 2>& Y) {
+        fill_uniform(X, -0.1, 0.1, RandomStream{3, 0});
+        for (size_t i = 0; i < X.shape()[0]; ++i) {
+            const double a = double((i / 2) % 2), b = double(i % 2);
+            X(i, 0) += a;
+            X(i, 1) += b;
+            Y(i, 0) = a != b ? 1.0 : 0.0;
+        }
+    }
+
+    void check_collectives(RingCommunicator& comm) {
+        // n no divisible entre los rangos, y n menor que el numero de rangos
+        for (size_t n : {size_t(10), size_t(2), size_t(1000)}) {
+            std::vector<double> values(n);
+            for (size_t i = 0; i < n; ++i) values[i] = comm.rank() * 100.0 + double(i);
+            comm.allreduce_sum(values.data(), n);
+            for (size_t i = 0; i < n; ++i) assert(values[i] == 300.0 + 3.0 * double(i));
+        }
+        std::vector<float> shared(7, float(comm.rank()));
+        comm.broadcast(shared.data(), shared.size(), 1);
+        for (float v : shared) assert(v == 1.0f);
+        comm.barrier();
+    }
+
+    // Con gradientes promediados, K procesos con batch b equivalen a un proceso con batch K * b
+    void check_training(RingCommunicator& comm) {
+        Tensor<double, 2> X(kWorld * kShardRows, 2), Y(kWorld * kShardRows, 1);
+        xor_data(X, Y);
+
+        // Pesos iniciales distintos por rango: DataParallel copia los del rango 0
+        NeuralNetwork<double> net;
+        build(net, 40 + uint64_t(comm.rank()));
+        std::vector<double> losses;
+        {
+            DataParallel<double> parallel(net, comm);
+            losses = parallel.train(shard_rows(X, comm.rank(), kWorld), shard_rows(Y, comm.rank(), kWorld),
+                                    4, kBatch, 0.5);
+        }
+        assert(losses.size() == 4);
+
+        Tensor<double, 2> X_ref(X.shape()[0], 2), Y_ref(Y.shape()[0], 1);
+        size_t row = 0;
+        for (size_t start = 0; start < kShardRows; start += kBatch)
+            for (size_t shard = 0; shard < size_t(kWorld); ++shard)
+                for (size_t i = 0; i < kBatch; ++i, ++row) {
+                    const size_t source = shard * kShardRows + start + i;
+                    X_ref(row, 0) = X(source, 0);
+                    X_ref(row, 1) = X(source, 1);
+                    Y_ref(row, 0) = Y(source, 0);
+                }
+        NeuralNetwork<double> reference;
+        build(reference, 40);
+        SGD<double> optimizer(0.5);
+        for (size_t epoch = 0; epoch < 4; ++epoch)
+            reference.train_epoch<BCELoss>(X_ref, Y_ref, kBatch * kWorld, optimizer, epoch);
+
+        for (size_t i = 0; i < net.layers().size(); ++i) {
+            auto* dense = dynamic_cast<Dense<double>*>(net.layers()[i].get());
+            if (!dense) continue;
+            auto* expected = dynamic_cast<Dense<double>*>(reference.layers()[i].get());
+            const auto W = dense->weights(), W_ref = expected->weights();
+            for (size_t k = 0; k < W.size(); ++k) assert(std::fabs(W[k] - W_ref[k]) < 1e-10);
+            for (size_t k = 0; k < dense->bias().size(); ++k)
+                assert(std::fabs(dense->bias()[k] - expected->bias()[k]) < 1e-10);
+        }
+    }
+
+    void check_mismatched_batches(RingCommunicator& comm) {
+        NeuralNetwork<double> net;
+        build(net, 7);
+        DataParallel<double> parallel(net, comm);
+        const size_t rows = comm.rank() == 0 ? 2 * kBatch : kBatch;
+        Tensor<double, 2> X(rows, 2), Y(rows, 1);
+        xor_data(X, Y);
+        bool thrown = false;
+        try {
+            parallel.train(X, Y, 1, kBatch, 0.1);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+}
+
+int main() {
+    std::cout << "Testing data-parallel training..." << std::endl;
+
+    const unsigned short port = static_cast<unsigned short>(20000 + ::getpid() % 20000);
+    const std::string unix_path = "/tmp/utec_nn_ring_" + std::to_string(::getpid());
+
+    // Un solo rango: las colectivas no hacen nada
+    RingCommunicator single(RingOptions{});
+    double value = 2.5;
+    single.allreduce_sum(&value, 1);
+    assert(value == 2.5);
+
+    for (bool use_unix : {false, true}) {
+        spawn([&](int rank) {
+            RingOptions options;
+            options.rank = rank;
+            options.world_size = kWorld;
+            options.base_port = port;
+            if (use_unix) options.unix_path = unix_path;
+            RingCommunicator comm(options);
+            check_collectives(comm);
+            check_training(comm);
+            check_mismatched_batches(comm);
+        });
+    }
+
+    std::cout << "All distributed tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,75 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include "../include/nn_ensemble.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    NeuralNetwork<double> mlp(size_t hidden, bool softmax) {
+        NeuralNetwork<double> net;
+        net.add_dense_layer(3, hidden);
+        net.add_relu_layer();
+        net.add_dense_layer(hidden, hidden);
+        net.add_sigmoid_layer();
+        net.add_dense_layer(hidden, softmax ? 4 : 1);
+        if (softmax) net.add_softmax_layer();
+        return net;
+    }
+
+}
+
+int main() {
+    std::cout << "Testing network ensembles..." << std::endl;
+
+    set_global_seed(3);
+    Tensor<double, 2> X(17, 3);
+    fill_uniform(X, -1.0, 1.0);
+
+    for (bool softmax : {false, true}) {
+        std::vector<NeuralNetwork<double>> networks;
+        for (size_t m = 0; m < 6; ++m) networks.push_back(mlp(8, softmax));
+
+        // Mismos kernels y mismo orden de suma: identico a predict modelo por modelo
+        NetworkEnsemble<double> ensemble(networks);
+        assert(ensemble.models() == 6 && ensemble.input_features() == 3);
+        auto Y = ensemble.predict(X);
+        assert(Y.shape()[0] == 6 && Y.shape()[1] == 17 && Y.shape()[2] == ensemble.output_features());
+        for (size_t m = 0; m < networks.size(); ++m) {
+            auto expected = networks[m].predict(X);
+            for (size_t i = 0; i < expected.shape()[0]; ++i)
+                for (size_t j = 0; j < expected.shape()[1]; ++j)
+                    assert(Y(m, i, j) == expected(i, j));
+        }
+
+        // Un batch distinto por modelo
+        Tensor<double, 3> per_model(6, 5, 3);
+        fill_uniform(per_model, -1.0, 1.0);
+        auto Z = ensemble.predict(per_model);
+        for (size_t m = 0; m < networks.size(); ++m) {
+            Tensor<double, 2> rows(5, 3);
+            std::copy(per_model.data() + m * 15, per_model.data() + (m + 1) * 15, rows.data());
+            auto expected = networks[m].predict(rows);
+            for (size_t i = 0; i < expected.size(); ++i)
+                assert(Z.data()[m * expected.size() + i] == expected[i]);
+        }
+    }
+
+    std::vector<NeuralNetwork<double>> mixed;
+    mixed.push_back(mlp(8, false));
+    mixed.push_back(mlp(4, false));
+    bool thrown = false;
+    try {
+        NetworkEnsemble<double> bad(mixed);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All ensemble tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cmath>
+#include "counting_new.h"
+#include "../include/neural_network.h"
+#include "../include/nn_graph.h"
+#include "../include/nn_conv.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    void build(NeuralNetwork<double>& net) {
+        auto init_w = [](Tensor<double, 2>& w) {
+            for (size_t i = 0; i < w.size(); ++i) w[i] = 0.1 * double(int(i % 11) - 5);
+        };
+        auto init_b = [](Tensor<double, 2>& b) { b.fill(0.05); };
+        net.add_layer(std::make_unique<Dense<double>>(3, 16, init_w, init_b));
+        net.add_relu_layer();
+        net.add_layer(std::make_unique<Dense<double>>(16, 8, init_w, init_b));
+        net.add_sigmoid_layer();
+        net.add_layer(std::make_unique<Dense<double>>(8, 1, init_w, init_b));
+        net.add_sigmoid_layer();
+    }
+
+}
+
+int main() {
+    std::cout << "Testing static graph..." << std::endl;
+
+    // Buffers con vidas disjuntas comparten offset; los solapados no
+    std::vector<BufferLifetime> buffers = {
+        {"a", 4, 4, 0, 1, 0}, {"b", 4, 4, 2, 3, 0}, {"c", 2, 2, 1, 2, 0}};
+    const size_t total = plan_memory(buffers);
+    assert(buffers[0].offset == buffers[1].offset);
+    assert(buffers[2].offset >= 16);
+    assert(total == 20);
+
+    const size_t samples = 10, batch = 4;
+    Tensor<double, 2> X(samples, 3), Y(samples, 1);
+    for (size_t i = 0; i < samples; ++i) {
+        X(i, 0) = double(i % 2);
+        X(i, 1) = double((i / 2) % 2);
+        X(i, 2) = 0.1 * double(i);
+        Y(i, 0) = double((i % 2) ^ ((i / 2) % 2));
+    }
+
+    NeuralNetwork<double> eager, planned;
+    build(eager);
+    build(planned);
+
+    StaticGraph<double, BCELoss> graph(planned, batch, 3);
+    assert(graph.output_features() == 1);
+    assert(graph.peak_bytes() < graph.unplanned_bytes());
+    graph.print_plan(std::cout);
+
+    // Mismos pesos y mismos kernels: el grafo reproduce el entrenamiento eager
+    eager.train<BCELoss, SGD>(X, Y, 3, batch, 0.5);
+    SGD<double> optimizer(0.5);
+    for (int epoch = 0; epoch < 3; ++epoch)
+        graph.train_epoch(X, Y, optimizer);
+
+    auto expected = eager.predict(X);
+    auto got = graph.predict(X);
+    for (size_t i = 0; i < expected.size(); ++i)
+        assert(std::fabs(expected[i] - got[i]) < 1e-12);
+
+    // Los pasos planificados no reservan memoria (ni tensores ni buffers internos de las capas)
+    size_t before = utec_test::heap_allocations();
+    for (size_t start = 0; start + batch <= samples; start += batch)
+        graph.train_step(X, Y, start, batch, optimizer);
+    graph.forward(X, 0, batch);
+    assert(utec_test::heap_allocations() == before);
+
+    // Lo mismo con convolucion y pooling: tras el primer paso (que dimensiona los buffers
+    // por hilo de im2col) el resto no reserva
+    {
+        set_global_seed(9);
+        NeuralNetwork<double> cnn;
+        cnn.add_layer(std::make_unique<Conv2D<double>>(ImageShape{1, 6, 6}, 3, 3, 1, 1));
+        cnn.add_relu_layer();
+        cnn.add_layer(std::make_unique<MaxPool2D<double>>(ImageShape{3, 6, 6}, 2));
+        cnn.add_dense_layer(3 * 3 * 3, 1);
+        cnn.add_sigmoid_layer();
+        Tensor<double, 2> images(8, 36), labels(8, 1);
+        fill_uniform(images, 0.0, 1.0);
+        for (size_t i = 0; i < 8; ++i) labels(i, 0) = double(i % 2);
+        StaticGraph<double, BCELoss> conv_graph(cnn, 4, 36);
+        SGD<double> sgd(0.1);
+        conv_graph.train_step(images, labels, 0, 4, sgd);
+        before = utec_test::heap_allocations();
+        for (int step = 0; step < 5; ++step)
+            conv_graph.train_step(images, labels, 4 * size_t(step % 2), 4, sgd);
+        conv_graph.forward(images, 0, 4);
+        assert(utec_test::heap_allocations() == before);
+    }
+
+    bool thrown = false;
+    try {
+        graph.train_step(X, Y, 0, batch + 1, optimizer);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All static graph tests passed!" << std::endl;
+    return 0;
+}
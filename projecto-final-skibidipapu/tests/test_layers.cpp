@@ -0,0 +1,144 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "../include/nn_activation.h"
+#include "../include/nn_loss.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+int main() {
+    std::cout << "Testing layers and losses..." << std::endl;
+
+    const size_t rows = 3, classes = 4;
+    Tensor<double, 2> logits(rows, classes);
+    logits = {1.0, -0.5, 2.0, 0.3,
+              -1.2, 0.0, 0.7, 3.1,
+              0.5, 0.5, -2.0, 1.0};
+    Tensor<double, 2> one_hot(rows, classes);
+    one_hot.fill(0.0);
+    Tensor<double, 2> labels(rows, 1);
+    labels = {2, 3, 0};
+    for (size_t i = 0; i < rows; ++i) one_hot(i, size_t(labels[i])) = 1.0;
+
+    // ReLU guarda 1 bit por elemento; el tamano no multiplo de 64 cubre la ultima palabra
+    Tensor<double, 2> z(7, 13), upstream(7, 13);
+    for (size_t i = 0; i < z.size(); ++i) {
+        z[i] = double(int(i % 9) - 4) * 0.25;
+        upstream[i] = 1.0 + double(i);
+    }
+    ReLU<double> relu;
+    auto relu_out = relu.forward(z);
+    assert(relu.cache_bytes() == 2 * sizeof(std::uint64_t));
+    auto relu_grad = relu.backward(upstream);
+    for (size_t i = 0; i < z.size(); ++i) {
+        assert(relu_out[i] == std::max(0.0, z[i]));
+        assert(relu_grad[i] == (z[i] > 0 ? upstream[i] : 0.0));
+    }
+    relu.release_cache();
+    assert(relu.cache_bytes() == 0);
+
+    // Sigmoid deriva desde su salida guardada
+    Sigmoid<double> sigmoid;
+    auto sig_out = sigmoid.forward(z);
+    auto sig_grad = sigmoid.backward(upstream);
+    for (size_t i = 0; i < z.size(); ++i) {
+        const double s = 1.0 / (1.0 + std::exp(-z[i]));
+        assert(std::fabs(sig_out[i] - s) < 1e-15);
+        assert(std::fabs(sig_grad[i] - upstream[i] * s * (1.0 - s)) < 1e-12);
+    }
+
+    // Softmax::backward contra diferencias finitas de sum(w * softmax(x))
+    Tensor<double, 2> weights(rows, classes);
+    for (size_t i = 0; i < weights.size(); ++i) weights[i] = 0.3 * double(int(i % 5) - 2);
+    auto objective = [&](const Tensor<double, 2>& x) {
+        Softmax<double> softmax;
+        auto p = softmax.forward(x);
+        double total = 0;
+        for (size_t i = 0; i < p.size(); ++i) total += weights[i] * p[i];
+        return total;
+    };
+    Softmax<double> softmax;
+    auto probabilities = softmax.forward(logits);
+    auto dX = softmax.backward(weights);
+    for (size_t i = 0; i < logits.size(); ++i) {
+        auto plus = logits, minus = logits;
+        plus[i] += 1e-6;
+        minus[i] -= 1e-6;
+        const double numeric = (objective(plus) - objective(minus)) / 2e-6;
+        assert(std::fabs(numeric - dX[i]) < 1e-8);
+    }
+
+    // Un gradiente de otra forma, o backward tras liberar la salida guardada, se rechaza
+    Softmax<double> guarded;
+    guarded.forward(logits);
+    auto softmax_rejects = [&](const Tensor<double, 2>& grad) {
+        try {
+            guarded.backward(grad);
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    assert(softmax_rejects(Tensor<double, 2>(rows + 1, classes)));
+    guarded.release_cache();
+    assert(softmax_rejects(weights));
+
+    // Softmax + CrossEntropy compuestos coinciden con la version fusionada
+    CrossEntropyLoss<double> unfused(probabilities, one_hot);
+    auto composed = softmax.backward(unfused.loss_gradient());
+    SoftmaxCrossEntropyLoss<double> fused(logits, one_hot);
+    SoftmaxCrossEntropyLoss<double> sparse(logits, labels);
+    auto fused_grad = fused.loss_gradient();
+    auto sparse_grad = sparse.loss_gradient();
+    assert(std::fabs(fused.loss() - unfused.loss()) < 1e-12);
+    assert(std::fabs(sparse.loss() - fused.loss()) < 1e-12);
+    for (size_t i = 0; i < composed.size(); ++i) {
+        assert(std::fabs(composed[i] - fused_grad[i]) < 1e-12);
+        assert(std::fabs(sparse_grad[i] - fused_grad[i]) < 1e-15);
+        assert(std::fabs(fused_grad[i] - (probabilities[i] - one_hot[i]) / rows) < 1e-15);
+    }
+
+    // Logits grandes: log-sum-exp no desborda
+    Tensor<double, 2> large = logits * 1000.0 + 5000.0;
+    SoftmaxCrossEntropyLoss<double> stable(large, labels);
+    assert(std::isfinite(stable.loss()));
+    auto stable_grad = stable.loss_gradient();
+    for (size_t i = 0; i < stable_grad.size(); ++i) assert(std::isfinite(stable_grad[i]));
+
+    // compute() coincide con loss() / loss_gradient() y reutiliza el buffer del llamador
+    Tensor<double, 2> grad_buffer(rows, classes);
+    const double* reused = grad_buffer.data();
+    assert(fused.compute(grad_buffer) == fused.loss());
+    assert(grad_buffer.data() == reused);
+    for (size_t i = 0; i < grad_buffer.size(); ++i) assert(grad_buffer[i] == fused_grad[i]);
+    MSELoss<double> mse(probabilities, one_hot);
+    Tensor<double, 2> mse_grad;
+    assert(mse.compute(mse_grad) == mse.loss());
+    auto expected_mse_grad = mse.loss_gradient();
+    for (size_t i = 0; i < mse_grad.size(); ++i) assert(mse_grad[i] == expected_mse_grad[i]);
+
+    bool mismatch = false;
+    try {
+        MSELoss<double> wrong(probabilities, labels);
+    } catch (const std::invalid_argument&) {
+        mismatch = true;
+    }
+    assert(mismatch);
+
+    bool thrown = false;
+    Tensor<double, 2> bad_labels(rows, 1);
+    bad_labels = {0, 4, 1};
+    try {
+        SoftmaxCrossEntropyLoss<double> bad(logits, bad_labels);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All layer tests passed!" << std::endl;
+    return 0;
+}
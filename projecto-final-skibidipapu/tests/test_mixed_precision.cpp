@@ -0,0 +1,74 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include "../include/bfloat16.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_mixed_precision.h"
+#include "../include/nn_optimizer.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+int main() {
+    std::cout << "Testing mixed precision..." << std::endl;
+
+    assert(float(bfloat16(1.0f)) == 1.0f);
+    assert(float(bfloat16(-2.5f)) == -2.5f);
+    assert(bfloat16(1.0f + 1.0f / 256.0f).bits() == bfloat16(1.0f).bits());
+    assert(bfloat16(1.0f + 3.0f / 256.0f).bits() == bfloat16(1.0f + 4.0f / 256.0f).bits());
+    assert(std::isnan(float(bfloat16(std::nanf("")))));
+    assert(std::isinf(float(bfloat16(INFINITY))));
+
+    Tensor<float, 2> values(2, 3);
+    values = {0.1f, -0.2f, 3.14159f, 100.5f, 1e-3f, -7.0f};
+    auto narrowed = tensor_cast<bfloat16>(values);
+    auto widened = tensor_cast<float>(narrowed);
+    for (size_t i = 0; i < values.size(); ++i)
+        assert(std::fabs(widened[i] - values[i]) <= std::fabs(values[i]) / 128.0f);
+
+    auto init_w = [](Tensor<float, 2>& w) {
+        for (size_t i = 0; i < w.size(); ++i) w[i] = 0.05f * float(int(i % 7) - 3);
+    };
+    auto init_b = [](Tensor<float, 2>& b) { b.fill(0.25f); };
+
+    Dense<float> reference(4, 3, init_w, init_b);
+    MixedDense<float> full(4, 3, init_w, init_b);
+    BF16Dense<float> half(4, 3, init_w, init_b);
+
+    Tensor<float, 2> X(2, 4);
+    X = {1.0f, 2.0f, -1.0f, 0.5f, 0.0f, -3.0f, 2.0f, 1.0f};
+    auto expected = reference.forward(X);
+    auto got_full = full.forward(X);
+    auto got_half = half.forward(X);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        assert(std::fabs(got_full[i] - expected[i]) < 1e-5f);
+        assert(std::fabs(got_half[i] - expected[i]) < 5e-2f);
+    }
+
+    Tensor<float, 2> dY(2, 3);
+    dY.fill(1.0f);
+    auto dx_ref = reference.backward(dY);
+    auto dx_full = full.backward(dY);
+    for (size_t i = 0; i < dx_ref.size(); ++i)
+        assert(std::fabs(dx_full[i] - dx_ref[i]) < 1e-5f);
+
+    // Actualizaciones menores a la resolucion de bf16 se pierden sin copia maestra
+    MasterWeights<float> master(1e-4f);
+    SGD<float> plain(1e-4f);
+    BF16Dense<float> with_master(4, 3, init_w, init_b);
+    BF16Dense<float> without_master(4, 3, init_w, init_b);
+    for (int step = 0; step < 50; ++step) {
+        with_master.forward(X);
+        with_master.backward(dY);
+        with_master.update_params(master);
+        without_master.forward(X);
+        without_master.backward(dY);
+        without_master.update_params(plain);
+    }
+    assert(float(with_master.bias()[0]) < 0.25f);
+    assert(float(without_master.bias()[0]) == 0.25f);
+
+    std::cout << "All mixed precision tests passed!" << std::endl;
+    return 0;
+}
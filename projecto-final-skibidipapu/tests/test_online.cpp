@@ -0,0 +1,179 @@
+#undef NDEBUG
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "counting_new.h"
+#include "../include/nn_online.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    NeuralNetwork<double> mlp() {
+        NeuralNetwork<double> net;
+        net.add_dense_layer(2, 8);
+        net.add_relu_layer();
+        net.add_dense_layer(8, 1);
+        net.add_sigmoid_layer();
+        return net;
+    }
+
+    std::vector<double> values(const Tensor<double, 2>& t) {
+        return std::vector<double>(t.cbegin(), t.cend());
+    }
+
+    void xor_batch(size_t rows, size_t offset, Tensor<double, 2>& X, Tensor<double, 2>& Y) {
+        X = Tensor<double, 2>(rows, 2);
+        Y = Tensor<double, 2>(rows, 1);
+        fill_uniform(X, -0.1, 0.1);
+        for (size_t i = 0; i < rows; ++i) {
+            const double a = double((i + offset) % 4 >= 2), b = double((i + offset) % 2);
+            X(i, 0) += a;
+            X(i, 1) += b;
+            Y(i, 0) = a != b;
+        }
+    }
+
+}
+
+int main() {
+    std::cout << "Testing online learning..." << std::endl;
+
+    set_global_seed(21);
+    auto reference = mlp();
+    set_global_seed(21);
+    OnlineOptions options;
+    options.max_batch = 8;
+    options.publish_every = 1;
+    OnlineLearner<double> learner(mlp(), 2, 0.1, options);
+    assert(learner.version() == 0 && learner.updates() == 0);
+
+    // Mismos pasos que StaticGraph sobre una red gemela: batches de 20 filas = pasos de 8, 8 y 4
+    StaticGraph<double> graph(reference, 8, 2);
+    SGD<double> sgd(0.1);
+    Tensor<double, 2> X, Y, probe, unused;
+    xor_batch(4, 0, probe, unused);
+    for (size_t update = 0; update < 5; ++update) {
+        xor_batch(20, update, X, Y);
+        double expected = 0;
+        for (size_t first = 0; first < 20; first += 8) {
+            const size_t rows = std::min<size_t>(8, 20 - first);
+            expected += graph.train_step(X, Y, first, rows, sgd) * double(rows);
+        }
+        const double loss = learner.partial_fit(X, Y);
+        assert(std::abs(loss - expected / 20.0) < 1e-12);
+    }
+    assert(learner.updates() == 5 && learner.version() == 5 && learner.samples_seen() == 100);
+    const auto online = learner.predict(probe);
+    const auto twin = reference.predict(probe);
+    for (size_t i = 0; i < twin.size(); ++i) assert(online[i] == twin[i]);
+    auto copy = learner.published_network();
+    const auto copied = copy.predict(probe);
+    for (size_t i = 0; i < twin.size(); ++i) assert(copied[i] == twin[i]);
+
+    // Publicacion cada 3 actualizaciones: los lectores siguen viendo la version anterior
+    {
+        OnlineOptions lazy;
+        lazy.publish_every = 3;
+        OnlineLearner<double> delayed(mlp(), 2, 0.1, lazy);
+        const auto before = delayed.predict(probe);
+        delayed.partial_fit(X, Y);
+        delayed.partial_fit(X, Y);
+        assert(delayed.version() == 0);
+        const auto stale = delayed.predict(probe);
+        for (size_t i = 0; i < before.size(); ++i) assert(stale[i] == before[i]);
+        delayed.partial_fit(X, Y);
+        assert(delayed.version() == 3);
+        delayed.partial_fit(X, Y);
+        delayed.publish();
+        assert(delayed.version() == 4);
+    }
+
+    // Con la publicacion por defecto (cada 16) las llamadas intermedias no reservan nada; la
+    // que publica clona la red
+    {
+        OnlineOptions batched;
+        batched.max_batch = 8;
+        assert(batched.publish_every > 2);
+        OnlineLearner<double> quiet(mlp(), 2, 0.1, batched);
+        xor_batch(20, 0, X, Y);
+        quiet.partial_fit(X, Y);
+        const size_t before = utec_test::heap_allocations();
+        for (size_t update = 2; update < batched.publish_every; ++update) quiet.partial_fit(X, Y);
+        assert(utec_test::heap_allocations() == before);
+        assert(quiet.version() == 0);
+        quiet.partial_fit(X, Y);
+        assert(utec_test::heap_allocations() > before);
+        assert(quiet.version() == batched.publish_every);
+        assert(quiet.update_latency().count == batched.publish_every);
+        assert(quiet.publish_latency().count == 2);
+    }
+
+    // Lectores concurrentes: cada prediccion coincide exactamente con alguna version publicada
+    {
+        set_global_seed(5);
+        OnlineLearner<double> shared(mlp(), 2, 0.05, options);
+        std::mutex mutex;
+        std::vector<std::vector<double>> published{values(shared.published_network().predict(probe))};
+        std::vector<std::vector<double>> observed;
+        std::atomic<bool> done{false};
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                std::vector<std::vector<double>> local;
+                while (!done.load()) local.push_back(values(shared.predict(probe)));
+                local.push_back(values(shared.predict(probe)));
+                std::lock_guard lock(mutex);
+                observed.insert(observed.end(), local.begin(), local.end());
+            });
+        }
+        for (size_t update = 0; update < 40; ++update) {
+            xor_batch(16, update, X, Y);
+            shared.partial_fit(X, Y);
+            auto snapshot = shared.published_network();
+            std::lock_guard lock(mutex);
+            published.push_back(values(snapshot.predict(probe)));
+        }
+        done = true;
+        for (auto& reader : readers) reader.join();
+
+        assert(!observed.empty());
+        for (const auto& output : observed)
+            assert(std::find(published.begin(), published.end(), output) != published.end());
+
+        const auto updates = shared.update_latency();
+        const auto predicts = shared.predict_latency();
+        assert(updates.count == 40);
+        assert(predicts.count == std::min<size_t>(observed.size(), options.latency_window));
+        for (const auto& s : {updates, predicts})
+            assert(s.p50_us <= s.p90_us && s.p90_us <= s.p99_us && s.p99_us <= s.max_us && s.max_us > 0);
+    }
+
+    // Ventana circular: solo cuentan las ultimas `capacity` mediciones
+    LatencyRecorder recorder(4);
+    for (int ms = 1; ms <= 6; ++ms) recorder.record(std::chrono::milliseconds(ms));
+    const auto window = recorder.summary();
+    assert(recorder.recorded() == 6 && window.count == 4);
+    assert(window.p50_us == 4000.0 && window.max_us == 6000.0);
+
+    bool thrown = false;
+    try {
+        Tensor<double, 2> wide(3, 5);
+        learner.predict(wide);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All online learning tests passed!" << std::endl;
+    return 0;
+}
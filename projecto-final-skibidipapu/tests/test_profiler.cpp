@@ -0,0 +1,171 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../include/neural_network.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    // Validador JSON minimo (objetos, arreglos, strings sin escapes unicode, numeros, literales)
+    class JsonChecker {
+        const std::string& text_;
+        size_t at_ = 0;
+
+        void skip() { while (at_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[at_]))) ++at_; }
+        bool eat(char c) {
+            skip();
+            if (at_ < text_.size() && text_[at_] == c) {
+                ++at_;
+                return true;
+            }
+            return false;
+        }
+
+        bool string() {
+            if (!eat('"')) return false;
+            while (at_ < text_.size() && text_[at_] != '"') at_ += text_[at_] == '\\' ? 2 : 1;
+            return at_++ < text_.size();
+        }
+
+        bool number() {
+            skip();
+            const size_t start = at_;
+            while (at_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[at_])) ||
+                                          std::string("+-.eE").find(text_[at_]) != std::string::npos)) ++at_;
+            return at_ > start;
+        }
+
+        bool value() {
+            skip();
+            if (at_ >= text_.size()) return false;
+            const char c = text_[at_];
+            if (c == '{') {
+                ++at_;
+                if (eat('}')) return true;
+                do {
+                    if (!string() || !eat(':') || !value()) return false;
+                } while (eat(','));
+                return eat('}');
+            }
+            if (c == '[') {
+                ++at_;
+                if (eat(']')) return true;
+                do {
+                    if (!value()) return false;
+                } while (eat(','));
+                return eat(']');
+            }
+            if (c == '"') return string();
+            for (const char* literal : {"true", "false", "null"}) {
+                if (text_.compare(at_, std::string(literal).size(), literal) == 0) {
+                    at_ += std::string(literal).size();
+                    return true;
+                }
+            }
+            return number();
+        }
+
+    public:
+        explicit JsonChecker(const std::string& text) : text_(text) {}
+        bool valid() {
+            const bool ok = value();
+            skip();
+            return ok && at_ == text_.size();
+        }
+    };
+
+    size_t count(const std::string& text, const std::string& pattern) {
+        size_t found = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) ++found;
+        return found;
+    }
+
+}
+
+int main() {
+    std::cout << "Testing profiler..." << std::endl;
+    static_assert(Profiler<double>::enabled(), "profiler_test se compila con UTEC_NN_PROFILING");
+
+    set_global_seed(4);
+    NeuralNetwork<double> net;
+    net.add_dense_layer(3, 5);
+    net.add_relu_layer();
+    net.add_dense_layer(5, 1);
+    net.add_sigmoid_layer();
+
+    const size_t samples = 40, batch = 16, steps = 3;
+    Tensor<double, 2> X(samples, 3), Y(samples, 1);
+    fill_uniform(X, -1.0, 1.0);
+    for (size_t i = 0; i < samples; ++i) Y(i, 0) = X(i, 0) > 0.0;
+
+    Profiler<double> profiler;
+    net.set_profiler(&profiler);
+    SGD<double> sgd(0.1);
+    for (size_t epoch = 0; epoch < 2; ++epoch) net.train_epoch<BCELoss>(X, Y, batch, sgd, epoch);
+
+    // Totales por epoca: una llamada por batch y FLOPs de Dense sumados sobre todas las filas
+    assert(profiler.epochs().size() == 2);
+    for (const auto& epoch : profiler.epochs()) {
+        assert(epoch.steps == steps);
+        assert(epoch.layers.size() == 5);
+        assert(epoch.layers[0].name == "Dense" && epoch.layers[1].name == "ReLU" && epoch.layers[4].name == "loss");
+        for (size_t layer = 0; layer < 4; ++layer) {
+            assert(epoch.layers[layer].phases[0].calls == steps);
+            assert(epoch.layers[layer].phases[1].calls == steps);
+        }
+        assert(epoch.layers[4].phases[3].calls == steps);
+
+        const auto& first = epoch.layers[0].phases;
+        assert(first[0].flops == 2.0 * samples * 15 + samples * 5);
+        assert(first[1].flops == 4.0 * samples * 15 + samples * 5);
+        assert(first[2].flops == steps * 2.0 * (15 + 5));
+        assert(epoch.layers[1].phases[0].flops == 0.0);
+        // Forward de Dense reserva al menos su salida
+        assert(first[0].bytes >= samples * 5 * sizeof(double));
+        assert(first[0].seconds >= 0.0);
+    }
+
+    std::ostringstream report;
+    profiler.write_epoch_report(report);
+    assert(report.str().find("Epoca 1") != std::string::npos && report.str().find("Epoca 2") != std::string::npos);
+
+    // quantize fusiona Dense + ReLU: los eventos ya grabados conservan los nombres anteriores
+    net.quantize(X);
+    assert(net.layers().size() == 3);
+    net.predict(X);
+    assert(profiler.predict_profile().steps == 1);
+    assert(profiler.predict_profile().layers.size() == 4);
+    assert(profiler.predict_profile().layers[0].name == "QuantizedDense+ReLU");
+
+    std::ostringstream trace;
+    profiler.write_chrome_trace(trace);
+    const std::string json = trace.str();
+    assert(JsonChecker(json).valid());
+    const size_t training_events = 2 * steps * (3 * 4 + 1);
+    assert(count(json, "\"ph\":\"X\"") == training_events + 3);
+    assert(count(json, "\"name\":\"3 Sigmoid backward\"") == 2 * steps);
+    assert(count(json, "\"name\":\"0 QuantizedDense+ReLU forward\"") == 1);
+    assert(count(json, "\"name\":\"2 Sigmoid forward\"") == 1);
+
+    // El contador de bytes es por hilo: otro hilo no altera lo medido en este
+    static_assert(std::is_same_v<utec::algebra::detail::TensorAllocator<double>,
+                                 utec::algebra::detail::CountingAllocator<double>>);
+    const size_t before = utec::algebra::detail::allocated_bytes();
+    std::thread([] { Tensor<double, 2> other(64, 64); }).join();
+    assert(utec::algebra::detail::allocated_bytes() == before);
+    Tensor<double, 2> mine(8, 8);
+    assert(utec::algebra::detail::allocated_bytes() == before + 64 * sizeof(double));
+
+    net.set_profiler(nullptr);
+    std::cout << "All profiler tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "../include/tensor.h"
+#include "../include/nn_dense.h"
+#include "../include/nn_quantization.h"
+#include "../include/neural_network.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+int main() {
+    std::cout << "Testing int8 quantization..." << std::endl;
+
+    // El kernel int32 debe ser exacto para cualquier tamano de fila
+    const size_t m = 3, n = 7, k_padded = 2 * kQuantBlock;
+    std::vector<uint8_t> x(m * k_padded);
+    std::vector<int8_t> w(n * k_padded);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = uint8_t((i * 37) % 128);
+    for (size_t i = 0; i < w.size(); ++i) w[i] = int8_t(int((i * 53) % 255) - 127);
+    std::vector<int32_t> acc(m * n);
+    utec::neural_network::detail::gemm_u8s8(x.data(), w.data(), acc.data(), m, n, k_padded);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            int32_t expected = 0;
+            for (size_t k = 0; k < k_padded; ++k)
+                expected += int32_t(x[i * k_padded + k]) * int32_t(w[j * k_padded + k]);
+            assert(acc[i * n + j] == expected);
+        }
+    }
+
+    auto init_w = [](Tensor<float, 2>& t) {
+        for (size_t i = 0; i < t.size(); ++i) t[i] = 0.1f * std::sin(float(i));
+    };
+    auto init_b = [](Tensor<float, 2>& t) { t.fill(0.05f); };
+    Dense<float> dense(40, 5, init_w, init_b);
+
+    Tensor<float, 2> X(8, 40);
+    for (size_t i = 0; i < X.size(); ++i) X[i] = std::cos(float(i) * 0.3f);
+
+    ActivationObserver<float> observer;
+    observer.observe(X);
+    QuantizedDense<float> quantized(dense, observer.params());
+    auto expected = dense.forward(X);
+    auto got = quantized.forward(X);
+    for (size_t i = 0; i < expected.size(); ++i)
+        assert(std::fabs(got[i] - expected[i]) < 0.05f);
+
+    NeuralNetwork<float> network;
+    network.add_layer(std::make_unique<Dense<float>>(40, 5, init_w, init_b));
+    network.add_relu_layer();
+    network.add_layer(std::make_unique<Dense<float>>(5, 1, init_w, init_b));
+    auto reference = network.predict(X);
+    network.quantize(X);
+    auto approx = network.predict(X);
+    for (size_t i = 0; i < reference.size(); ++i)
+        assert(std::fabs(approx[i] - reference[i]) < 0.05f);
+
+    std::cout << "All quantization tests passed!" << std::endl;
+    return 0;
+}
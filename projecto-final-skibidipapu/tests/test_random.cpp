@@ -0,0 +1,97 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include "../include/tensor_random.h"
+#include "../include/nn_dense.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace utec::algebra;
+
+namespace {
+
+    // Ejecuta body con `threads` hilos de OpenMP; sin OpenMP solo hay uno
+    template<typename F>
+    void with_threads(int threads, F&& body) {
+#ifdef _OPENMP
+        const int previous = omp_get_max_threads();
+        omp_set_num_threads(threads);
+        body();
+        omp_set_num_threads(previous);
+#else
+        (void)threads;
+        body();
+#endif
+    }
+
+}
+
+int main() {
+    std::cout << "Testing counter-based RNG..." << std::endl;
+
+    // Vectores de referencia de Philox4x32-10 (Random123)
+    auto zero = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    assert(zero[0] == 0x6627e8d5u && zero[1] == 0xe169c58du && zero[2] == 0xbc57ac4cu && zero[3] == 0x9b00dbd8u);
+    auto ones = Philox4x32::generate({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu});
+    assert(ones[0] == 0x408f276du && ones[1] == 0x41c83b0eu && ones[2] == 0xa20bc7c6u && ones[3] == 0x6d5451fdu);
+
+    // Misma semilla y flujo: mismos valores; el elemento i no depende del tamano del tensor
+    const RandomStream stream{7, 3};
+    Tensor<double, 2> a(100, 33), b(100, 33), prefix(5, 3);
+    fill_uniform(a, -2.0, 3.0, stream);
+    fill_uniform(b, -2.0, 3.0, stream);
+    fill_uniform(prefix, -2.0, 3.0, stream);
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(a[i] == b[i]);
+        assert(a[i] > -2.0 && a[i] < 3.0);
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) assert(prefix[i] == a[i]);
+
+    // Otro flujo da otra secuencia
+    fill_uniform(b, -2.0, 3.0, RandomStream{7, 4});
+    size_t equal = 0;
+    for (size_t i = 0; i < a.size(); ++i) equal += a[i] == b[i];
+    assert(equal == 0);
+
+    // El llenado en paralelo no depende del numero de hilos (tamano impar: bloque final partido)
+    Tensor<double, 2> serial_u(301, 77), threaded_u(301, 77), serial_n(301, 77), threaded_n(301, 77);
+    with_threads(1, [&] {
+        fill_uniform(serial_u, -1.0, 1.0, stream);
+        fill_normal(serial_n, 0.0, 1.0, stream);
+    });
+    with_threads(4, [&] {
+        fill_uniform(threaded_u, -1.0, 1.0, stream);
+        fill_normal(threaded_n, 0.0, 1.0, stream);
+    });
+    for (size_t i = 0; i < serial_u.size(); ++i) {
+        assert(serial_u[i] == threaded_u[i]);
+        assert(serial_n[i] == threaded_n[i]);
+    }
+
+    // Momentos de la normal
+    Tensor<double, 2> normal(400, 250);
+    fill_normal(normal, 1.5, 2.0, stream);
+    double mean = 0, var = 0;
+    for (size_t i = 0; i < normal.size(); ++i) mean += normal[i];
+    mean /= double(normal.size());
+    for (size_t i = 0; i < normal.size(); ++i) var += (normal[i] - mean) * (normal[i] - mean);
+    var /= double(normal.size());
+    assert(std::fabs(mean - 1.5) < 0.02);
+    assert(std::fabs(std::sqrt(var) - 2.0) < 0.02);
+
+    // La semilla global hace reproducible la inicializacion de Dense
+    set_global_seed(99);
+    utec::neural_network::Dense<float> first(16, 8);
+    set_global_seed(99);
+    utec::neural_network::Dense<float> second(16, 8);
+    utec::neural_network::Dense<float> third(16, 8);
+    const auto w1 = first.weights(), w2 = second.weights(), w3 = third.weights();
+    for (size_t i = 0; i < w1.size(); ++i) assert(w1[i] == w2[i]);
+    assert(w1[0] != w3[0]);
+    assert(global_seed() == 99);
+
+    std::cout << "All RNG tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,145 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "../include/nn_dense.h"
+#include "../include/nn_optimizer.h"
+#include "../include/nn_sparse.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    bool close(double a, double b) { return std::fabs(a - b) < 1e-12; }
+
+}
+
+int main() {
+    std::cout << "Testing magnitude pruning and CSR Dense..." << std::endl;
+
+    // Poda exacta: se van los de menor magnitud
+    Tensor<double, 2> M(2, 4);
+    M = {0.5, -0.1, 2.0, 0.1, -3.0, 0.1, 0.2, -0.05};
+    magnitude_prune(M, 0.5);
+    const double pruned[] = {0.5, 0.0, 2.0, 0.0, -3.0, 0.0, 0.2, 0.0};
+    for (size_t i = 0; i < M.size(); ++i) assert(M[i] == pruned[i]);
+    assert(sparsity(M) == 0.5);
+    bool thrown = false;
+    try {
+        magnitude_prune(M, 1.5);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Kernels CSR contra los productos densos
+    const size_t rows = 6, in = 9, out = 7;
+    Tensor<double, 2> W(in, out), X(rows, in), dY(rows, out);
+    fill_uniform(W, -1.0, 1.0, RandomStream{1, 0});
+    fill_uniform(X, -1.0, 1.0, RandomStream{1, 1});
+    fill_uniform(dY, -1.0, 1.0, RandomStream{1, 2});
+    X(2, 3) = 0.0;
+    magnitude_prune(W, 0.7);
+    const auto csr = CsrMatrix<double>::from_dense(W);
+    assert(csr.rows() == in && csr.cols() == out);
+    assert(csr.nnz() == W.size() - size_t(std::llround(0.7 * double(W.size()))));
+    const auto roundtrip = csr.to_dense();
+    for (size_t i = 0; i < W.size(); ++i) assert(roundtrip[i] == W[i]);
+
+    Tensor<double, 2> Y(rows, out);
+    Y.fill(1.0);
+    csr.multiply_accumulate(X.data(), rows, Y.data());
+    const auto XW = X.matmul(W);
+    for (size_t i = 0; i < Y.size(); ++i) assert(close(Y[i], XW[i] + 1.0));
+
+    Tensor<double, 2> dX(rows, in);
+    csr.multiply_transposed(dY.data(), rows, dX.data());
+    const auto dYWt = dY.matmul(W.transpose());
+    for (size_t i = 0; i < dX.size(); ++i) assert(close(dX[i], dYWt[i]));
+
+    std::vector<double> sampled(csr.nnz());
+    csr.sampled_gradient(X.data(), dY.data(), rows, sampled.data());
+    const auto XtdY = X.transpose().matmul(dY);
+    for (size_t k = 0, p = 0; k < in; ++k)
+        for (size_t j = 0; j < out; ++j)
+            if (W(k, j) != 0.0) assert(close(sampled[p++], XtdY(k, j)));
+
+    // Dense podado por encima del umbral pasa a CSR y entrena igual que la misma capa densa
+    // con los pesos podados, salvo que las posiciones podadas quedan fijas en cero
+    set_global_seed(2);
+    Dense<double> sparse(in, out);
+    sparse.prune(0.85);
+    assert(sparse.is_sparse());
+    const Tensor<double, 2> W0 = sparse.weights();
+    Dense<double> dense(in, out, [&](Tensor<double, 2>& w) { w = W0; },
+                        [](Tensor<double, 2>& b) { b.fill(0.0); });
+    dense.set_sparse_enabled(false);
+    assert(!dense.is_sparse());
+    assert(sparse.nonzero_weights() < dense.nonzero_weights());
+    assert(sparse.parameter_bytes() < dense.parameter_bytes());
+
+    SGD<double> sgd(0.1);
+    for (int step = 0; step < 3; ++step) {
+        // Referencia fresca en cada paso: misma capa con los pesos actuales guardados densos
+        const Tensor<double, 2> Wk = sparse.weights(), bk = sparse.bias();
+        Dense<double> reference(in, out, [&](Tensor<double, 2>& w) { w = Wk; },
+                                [&](Tensor<double, 2>& b) { b = bk; });
+        reference.set_sparse_enabled(false);
+
+        const auto ys = sparse.forward(X);
+        const auto yd = reference.forward(X);
+        for (size_t i = 0; i < ys.size(); ++i) assert(close(ys[i], yd[i]));
+        const auto dxs = sparse.backward(dY);
+        const auto dxd = reference.backward(dY);
+        for (size_t i = 0; i < dxs.size(); ++i) assert(close(dxs[i], dxd[i]));
+
+        // Gradiente enmascarado: el valor CSR p es el de la posicion densa que representa
+        const auto& gs = sparse.weight_gradient();
+        const auto& gd = reference.weight_gradient();
+        assert(gs.size() == sparse.nonzero_weights());
+        for (size_t k = 0, p = 0; k < in; ++k)
+            for (size_t j = 0; j < out; ++j)
+                if (W0(k, j) != 0.0) assert(close(gs[p++], gd(k, j)));
+        for (size_t j = 0; j < out; ++j) assert(close(sparse.bias_gradient()[j], reference.bias_gradient()[j]));
+
+        // El paso de SGD coincide en las posiciones vivas; las podadas siguen en cero aunque
+        // la referencia densa si las mueva
+        sparse.update_params(sgd);
+        reference.update_params(sgd);
+        const auto Ws = sparse.weights(), Wd = reference.weights();
+        size_t moved = 0;
+        for (size_t i = 0; i < Ws.size(); ++i) {
+            if (W0[i] == 0.0) {
+                assert(Ws[i] == 0.0);
+                moved += Wd[i] != 0.0;
+            } else {
+                assert(close(Ws[i], Wd[i]));
+            }
+        }
+        assert(moved > 0);
+        for (size_t j = 0; j < out; ++j) assert(close(sparse.bias()[j], reference.bias()[j]));
+    }
+    assert(sparse.is_sparse());
+
+    // Con el modo disperso desactivado la capa vuelve a denso sin cambiar los pesos
+    const auto before = sparse.weights();
+    sparse.set_sparse_enabled(false);
+    assert(!sparse.is_sparse());
+    for (size_t i = 0; i < before.size(); ++i) assert(sparse.weights()[i] == before[i]);
+    sparse.set_sparse_enabled(true);
+    assert(sparse.is_sparse());
+
+    thrown = false;
+    try {
+        sparse.set_sparse_threshold(2.0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All sparse tests passed!" << std::endl;
+    return 0;
+}
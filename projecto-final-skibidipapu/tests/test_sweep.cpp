@@ -0,0 +1,154 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <tuple>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/nn_sweep.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    void build(NeuralNetwork<double>& net, const SweepConfig<double>& config) {
+        net.add_dense_layer(2, config.hidden);
+        net.add_relu_layer();
+        net.add_dense_layer(config.hidden, 1);
+        net.add_sigmoid_layer();
+    }
+
+    void xor_data(size_t rows, Tensor<double, 2>& X, Tensor<double, 2>& Y) {
+        X = Tensor<double, 2>(rows, 2);
+        Y = Tensor<double, 2>(rows, 1);
+        fill_uniform(X, -0.1, 0.1);
+        for (size_t i = 0; i < rows; ++i) {
+            const double a = double(i % 4 >= 2), b = double(i % 2);
+            X(i, 0) += a;
+            X(i, 1) += b;
+            Y(i, 0) = a != b;
+        }
+    }
+
+    std::vector<SweepResult<double>> sweep(const std::vector<SweepConfig<double>>& configs, size_t workers,
+                                           const Tensor<double, 2>& X, const Tensor<double, 2>& Y,
+                                           const Tensor<double, 2>& Xv, const Tensor<double, 2>& Yv) {
+        SweepOptions options;
+        options.min_epochs = 2;
+        options.max_epochs = 12;
+        options.eta = 2;
+        options.workers = workers;
+        HyperparameterSweep<double> runner(build, options);
+        return runner.run(configs, X, Y, Xv, Yv);
+    }
+
+}
+
+int main() {
+    std::cout << "Testing hyperparameter sweeps..." << std::endl;
+
+    SweepSpace<double> space;
+    space.batch_sizes = {16, 64};
+    space.learning_rates = {0.01, 0.1};
+    space.hidden_widths = {4, 8};
+    const auto grid = space.grid();
+    assert(grid.size() == 8);
+    std::set<std::tuple<size_t, double, size_t>> distinct;
+    for (size_t i = 0; i < grid.size(); ++i) {
+        assert(grid[i].id == i);
+        distinct.insert({grid[i].batch_size, grid[i].learning_rate, grid[i].hidden});
+    }
+    assert(distinct.size() == 8);
+
+    // Busqueda aleatoria: reproducible por semilla y con lr dentro del rango
+    const auto random = space.random(20, 7);
+    const auto again = space.random(20, 7);
+    const auto other = space.random(20, 8);
+    bool differs = false;
+    for (size_t i = 0; i < random.size(); ++i) {
+        assert(random[i].learning_rate == again[i].learning_rate);
+        assert(random[i].batch_size == again[i].batch_size && random[i].hidden == again[i].hidden);
+        assert(random[i].learning_rate >= 0.01 && random[i].learning_rate <= 0.1);
+        differs |= random[i].learning_rate != other[i].learning_rate;
+    }
+    assert(differs);
+
+    set_global_seed(11);
+    Tensor<double, 2> X, Y, Xv, Yv;
+    xor_data(256, X, Y);
+    xor_data(64, Xv, Yv);
+
+    // 8 -> 4 -> 2 -> 1 con eta = 2: presupuestos 2, 4, 8 y la ganadora llega a 12
+    const auto serial = sweep(grid, 1, X, Y, Xv, Yv);
+    assert(serial.size() == 8);
+    std::vector<size_t> per_rung(4, 0);
+    for (const auto& r : serial) {
+        ++per_rung[r.rung];
+        const size_t expected[] = {2, 4, 8, 12};
+        assert(r.epochs == expected[r.rung]);
+        assert(r.val_accuracy >= 0.0 && r.val_accuracy <= 1.0);
+        assert(r.seconds >= 0.0);
+    }
+    assert(per_rung[0] == 4 && per_rung[1] == 2 && per_rung[2] == 1 && per_rung[3] == 1);
+    assert(serial.front().rung == 3);
+    for (size_t i = 1; i < serial.size(); ++i) {
+        assert(serial[i - 1].rung >= serial[i].rung);
+        if (serial[i - 1].rung == serial[i].rung) assert(serial[i - 1].val_loss <= serial[i].val_loss);
+    }
+
+    // Redes creadas en orden antes de lanzar los hilos: mismo resultado con cualquier numero de workers
+    const auto parallel = sweep(grid, 3, X, Y, Xv, Yv);
+    for (size_t i = 0; i < serial.size(); ++i) {
+        assert(parallel[i].config.id == serial[i].config.id);
+        assert(parallel[i].epochs == serial[i].epochs);
+        assert(parallel[i].val_loss == serial[i].val_loss);
+        assert(parallel[i].train_loss == serial[i].train_loss);
+    }
+
+    // Learning rates que divergen (perdida NaN) cuentan como +inf: quedan ultimas en cada
+    // ronda y se eliminan en la primera, sin desplazar a las configuraciones sanas
+    std::vector<SweepConfig<double>> mixed;
+    for (double lr : {1e300, 0.1, 1e200, 0.05, 1e250, 0.2, 1e6, 0.01})
+        mixed.push_back({mixed.size(), 16, lr, 8});
+    const auto ranked = sweep(mixed, 2, X, Y, Xv, Yv);
+    size_t diverged = 0;
+    for (const auto& r : ranked) {
+        if (std::isnan(r.val_loss)) {
+            ++diverged;
+            assert(r.rung == 0);
+        }
+    }
+    assert(diverged == 3);
+    assert(std::isfinite(ranked.front().val_loss));
+    for (size_t i = 1; i < ranked.size(); ++i) {
+        if (ranked[i - 1].rung != ranked[i].rung) continue;
+        if (std::isnan(ranked[i - 1].val_loss)) assert(std::isnan(ranked[i].val_loss));
+        else if (!std::isnan(ranked[i].val_loss)) assert(ranked[i - 1].val_loss <= ranked[i].val_loss);
+    }
+
+    std::ostringstream csv, json;
+    write_sweep_csv(csv, serial);
+    write_sweep_json(json, serial);
+    size_t lines = 0;
+    for (char c : csv.str()) lines += c == '\n';
+    assert(lines == serial.size() + 1);
+    assert(csv.str().rfind("id,batch_size,learning_rate,hidden,rung,epochs", 0) == 0);
+    assert(json.str().front() == '[' && json.str().find("\"val_loss\"") != std::string::npos);
+
+    bool thrown = false;
+    try {
+        SweepOptions bad;
+        bad.eta = 1;
+        HyperparameterSweep<double> runner(build, bad);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All sweep tests passed!" << std::endl;
+    return 0;
+}
@@ -1,6 +1,34 @@
+#undef NDEBUG
 #include <iostream>
 #include <cassert>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
 #include "../include/tensor.h"
+#include "../include/tensor_reduce.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+    // Sin OpenMP el cuerpo corre igual, con un solo hilo
+    template<typename F>
+    void with_threads(int threads, F&& body) {
+#ifdef _OPENMP
+        const int previous = omp_get_max_threads();
+        omp_set_num_threads(threads);
+        body();
+        omp_set_num_threads(previous);
+#else
+        (void)threads;
+        body();
+#endif
+    }
+
+}
 
 int main() {
     std::cout << "Testing UTEC Tensor System..." << std::endl;
@@ -35,7 +63,227 @@ int main() {
     
     std::cout << "A + B^T:\n" << D << std::endl;
     std::cout << "A * 2:\n" << E << std::endl;
-    
+
+    // Expresiones perezosas: misma semantica que la evaluacion operador por operador
+    assert(D(1, 2) == A(1, 2) + B(2, 1));
+    assert(E(1, 0) == 8.0);
+
+    utec::algebra::Tensor<double, 2> F = A * 2.0 + 1.0 - A / 2.0;
+    for (size_t i = 0; i < A.size(); ++i) {
+        assert(F[i] == A[i] * 2.0 + 1.0 - A[i] / 2.0);
+    }
+
+    utec::algebra::Tensor<double, 2> row(1, 3);
+    row = {10, 20, 30};
+    utec::algebra::Tensor<double, 2> col(2, 1);
+    col = {100, 200};
+    utec::algebra::Tensor<double, 2> G = A + row;
+    assert(G(1, 2) == 36.0);
+    utec::algebra::Tensor<double, 2> H = col + row * 2.0;
+    assert(H.shape()[0] == 2 && H.shape()[1] == 3);
+    assert(H(1, 0) == 220.0 && H(0, 2) == 160.0);
+
+    utec::algebra::Tensor<double, 2> I = A;
+    I = I * I + 2.0 * I;
+    assert(I(1, 1) == 35.0);
+    I = I + col;
+    assert(I(0, 0) == 103.0);
+
+    // Sin perfilador Tensor reserva con std::allocator, sin contar bytes
+#ifndef UTEC_NN_PROFILING
+    static_assert(std::is_same_v<utec::algebra::detail::TensorAllocator<double>, std::allocator<double>>);
+    assert(utec::algebra::detail::allocated_bytes() == 0);
+#endif
+
+    // Entre Tensor los operadores siguen devolviendo un Tensor: auto guarda el valor y el
+    // resultado admite toda la interfaz de Tensor
+    utec::algebra::Tensor<double, 2> J = A;
+    auto sum_ab = J + A * 2.0;
+    static_assert(std::is_same_v<decltype(sum_ab), utec::algebra::Tensor<double, 2>>);
+    J(0, 0) = 100.0;
+    assert(sum_ab(0, 0) == A(0, 0) * 3.0);
+    sum_ab(0, 0) = 5.0;
+    assert(sum_ab(0, 0) == 5.0);
+    assert((J + A).transpose()(1, 0) == J(0, 1) + A(0, 1));
+    assert((J + A).sum_rows()(0, 0) == J(0, 0) + A(0, 0) + J(1, 0) + A(1, 0));
+    assert((J - A).matmul(B)(0, 0) == (J(0, 0) - A(0, 0)) * B(0, 0) + (J(0, 1) - A(0, 1)) * B(1, 0) +
+                                         (J(0, 2) - A(0, 2)) * B(2, 0));
+
+    // lazy() arma una expresion en un solo recorrido con los mismos resultados; referencia
+    // al Tensor con nombre, asi que ve sus cambios hasta que se evalua
+    utec::algebra::Tensor<double, 2> fused = utec::algebra::lazy(A) * 2.0 + 1.0 - utec::algebra::lazy(A) / 2.0;
+    for (size_t i = 0; i < A.size(); ++i) assert(fused[i] == F[i]);
+    utec::algebra::Tensor<double, 2> K = A;
+    auto view = utec::algebra::lazy(K) + 1.0;
+    static_assert(!std::is_same_v<decltype(view), utec::algebra::Tensor<double, 2>>);
+    K(0, 0) = 100.0;
+    assert(view(0, 0) == 101.0 && view.eval()(0, 0) == 101.0);
+    auto owned = utec::algebra::lazy(K.transpose()) * 2.0;
+    K(0, 1) = -1.0;
+    assert(owned(1, 0) == A(0, 1) * 2.0);
+
+    bool thrown = false;
+    try {
+        utec::algebra::Tensor<double, 2> bad = A + B;
+        (void)bad;
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Producto por lotes (Rank 3) contra la definicion
+    utec::algebra::Tensor<double, 3> P(3, 2, 4), Q(3, 4, 5);
+    for (size_t i = 0; i < P.size(); ++i) P.data()[i] = double(i % 7) - 3.0;
+    for (size_t i = 0; i < Q.size(); ++i) Q.data()[i] = double(i % 5) * 0.5;
+    auto R = utec::algebra::matrix_product(P, Q);
+    for (size_t l = 0; l < 3; ++l)
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t j = 0; j < 5; ++j) {
+                double expected = 0;
+                for (size_t k = 0; k < 4; ++k) expected += P(l, i, k) * Q(l, k, j);
+                assert(R(l, i, j) == expected);
+            }
+
+    // Suma compensada: 1 + muchos terminos diminutos no se pierden por redondeo
+    const size_t n = 100000;
+    std::vector<double> terms(n, 1e-16);
+    terms[0] = 1.0;
+    const double sum = utec::algebra::parallel_sum<double>(n, [&](size_t i) { return terms[i]; });
+    assert(std::abs(sum - (1.0 + (n - 1) * 1e-16)) < 1e-15);
+    assert(sum == utec::algebra::parallel_sum<double>(n, [&](size_t i) { return terms[i]; }));
+    assert(utec::algebra::parallel_sum<double>(0, [](size_t) { return 1.0; }) == 0.0);
+
+    // Reducciones por eje contra la definicion, en cada eje de un Rank 3
+    utec::algebra::Tensor<double, 3> S(4, 5, 6);
+    for (size_t i = 0; i < S.size(); ++i) S[i] = double((i * 37) % 11) - 5.0;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        const auto total = utec::algebra::sum(S, axis);
+        const auto average = utec::algebra::mean(S, axis);
+        const auto high = utec::algebra::amax(S, axis);
+        const auto low = utec::algebra::amin(S, axis);
+        const auto where = utec::algebra::argmax(S, axis);
+        const auto lse = utec::algebra::logsumexp(S, axis);
+        assert(total.shape()[axis] == 1 && where.shape()[axis] == 1);
+        for (size_t o = 0; o < total.size(); ++o) {
+            std::array<size_t, 3> idx{o / (total.shape()[1] * total.shape()[2]),
+                                      (o / total.shape()[2]) % total.shape()[1], o % total.shape()[2]};
+            double s = 0, hi = -1e300, lo = 1e300, e = 0;
+            size_t at = 0;
+            for (size_t k = 0; k < S.shape()[axis]; ++k) {
+                idx[axis] = k;
+                const double v = S(idx[0], idx[1], idx[2]);
+                s += v;
+                if (v > hi) { hi = v; at = k; }
+                lo = std::min(lo, v);
+            }
+            for (size_t k = 0; k < S.shape()[axis]; ++k) {
+                idx[axis] = k;
+                e += std::exp(S(idx[0], idx[1], idx[2]) - hi);
+            }
+            assert(total[o] == s);
+            assert(std::abs(average[o] - s / double(S.shape()[axis])) < 1e-12);
+            assert(high[o] == hi && low[o] == lo && where[o] == at);
+            assert(std::abs(lse[o] - (hi + std::log(e))) < 1e-12);
+        }
+    }
+    auto sums = A.sum_rows();
+    assert(sums.shape()[0] == 1 && sums(0, 1) == A(0, 1) + A(1, 1));
+
+    // Ejes largos: se parten en tramos paralelos, con compensacion y sin depender de los hilos
+    utec::algebra::Tensor<double, 2> wide(2, n), tall(n, 3);
+    for (size_t i = 0; i < n; ++i) {
+        wide(0, i) = terms[i];
+        wide(1, i) = -double(i % 1000);
+        tall(i, 0) = terms[i];
+        tall(i, 1) = double(i % 1000);
+        tall(i, 2) = 2.0;
+    }
+    wide(1, 777) = 1.0;
+    wide(1, 90000) = 1.0;
+    const auto wide_sum = utec::algebra::sum(wide, 1);
+    const auto tall_sum = utec::algebra::sum(tall, 0);
+    assert(std::abs(wide_sum[0] - (1.0 + (n - 1) * 1e-16)) < 1e-15);
+    assert(std::abs(tall_sum[0] - (1.0 + (n - 1) * 1e-16)) < 1e-15);
+    assert(tall_sum[2] == 2.0 * double(n));
+    assert(utec::algebra::argmax(wide, 1)[1] == 777);
+    assert(utec::algebra::argmax(tall, 0)[1] == 999);
+    assert(utec::algebra::amin(wide, 1)[1] == -999.0);
+    // log-sum-exp no desborda con valores grandes
+    tall.fill(1000.0);
+    assert(std::abs(utec::algebra::logsumexp(tall, 0)[0] - (1000.0 + std::log(double(n)))) < 1e-9);
+
+    // Mismos bits con 1 y con 4 hilos: tramos por eje (eje 0), filas en paralelo (eje 2) y
+    // la suma compensada global
+    utec::algebra::Tensor<double, 3> big(40, 50, 60);
+    for (size_t i = 0; i < big.size(); ++i) big[i] = std::sin(double(i)) * 1e3 + 1e-7 * double(i % 13);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        utec::algebra::Tensor<double, 3> serial[5], threaded[5];
+        utec::algebra::Tensor<size_t, 3> serial_at, threaded_at;
+        auto reduce = [&](utec::algebra::Tensor<double, 3>* out, utec::algebra::Tensor<size_t, 3>& at) {
+            out[0] = utec::algebra::sum(big, axis);
+            out[1] = utec::algebra::mean(big, axis);
+            out[2] = utec::algebra::amax(big, axis);
+            out[3] = utec::algebra::amin(big, axis);
+            out[4] = utec::algebra::logsumexp(big, axis);
+            at = utec::algebra::argmax(big, axis);
+        };
+        with_threads(1, [&] { reduce(serial, serial_at); });
+        with_threads(4, [&] { reduce(threaded, threaded_at); });
+        for (size_t r = 0; r < 5; ++r)
+            for (size_t i = 0; i < serial[r].size(); ++i) assert(serial[r][i] == threaded[r][i]);
+        for (size_t i = 0; i < serial_at.size(); ++i) assert(serial_at[i] == threaded_at[i]);
+    }
+    double serial_total = 0, threaded_total = 0;
+    with_threads(1, [&] { serial_total = utec::algebra::parallel_sum<double>(n, [&](size_t i) { return big[i % big.size()]; }); });
+    with_threads(4, [&] { threaded_total = utec::algebra::parallel_sum<double>(n, [&](size_t i) { return big[i % big.size()]; }); });
+    assert(serial_total == threaded_total);
+
+    thrown = false;
+    try {
+        utec::algebra::sum(S, 3);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Transpuesta por bloques: bordes parciales, lotes y float/double
+    for (auto [r, c] : {std::pair<size_t, size_t>{1, 1}, {7, 13}, {64, 65}, {130, 9}, {17, 200}}) {
+        utec::algebra::Tensor<double, 2> M(r, c);
+        utec::algebra::Tensor<float, 2> Mf(r, c);
+        for (size_t i = 0; i < M.size(); ++i) {
+            M[i] = double(i);
+            Mf[i] = float(i);
+        }
+        const auto Mt = M.transpose();
+        const auto Mft = Mf.transpose();
+        assert(Mt.shape()[0] == c && Mt.shape()[1] == r);
+        for (size_t i = 0; i < r; ++i)
+            for (size_t j = 0; j < c; ++j)
+                assert(Mt(j, i) == M(i, j) && Mft(j, i) == Mf(i, j));
+    }
+    utec::algebra::Tensor<float, 3> batch(3, 19, 33);
+    for (size_t i = 0; i < batch.size(); ++i) batch[i] = float(i);
+    const auto batch_t = batch.transpose_2d();
+    for (size_t l = 0; l < 3; ++l)
+        for (size_t i = 0; i < 19; ++i)
+            for (size_t j = 0; j < 33; ++j)
+                assert(batch_t(l, j, i) == batch(l, i, j));
+
+    for (size_t side : {1, 8, 13, 67}) {
+        utec::algebra::Tensor<double, 3> square(2, side, side);
+        for (size_t i = 0; i < square.size(); ++i) square[i] = double(i);
+        const auto expected = square.transpose_2d();
+        square.transpose_in_place();
+        for (size_t i = 0; i < square.size(); ++i) assert(square[i] == expected[i]);
+    }
+    thrown = false;
+    try {
+        batch.transpose_in_place();
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
     std::cout << "All tensor tests passed!" << std::endl;
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,123 @@
+#undef NDEBUG
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include "counting_new.h"
+#include "../include/nn_training.h"
+#include "../include/tensor_random.h"
+
+using namespace utec::algebra;
+using namespace utec::neural_network;
+
+namespace {
+
+    void build(NeuralNetwork<double>& net) {
+        set_global_seed(11);
+        net.add_layer(std::make_unique<Dense<double>>(2, 16));
+        net.add_relu_layer();
+        net.add_layer(std::make_unique<Dense<double>>(16, 1));
+        net.add_sigmoid_layer();
+    }
+
+    void xor_data(Tensor<double, 2>& X, Tensor<double, 2>& Y) {
+        fill_uniform(X, -0.1, 0.1, RandomStream{5, 0});
+        for (size_t i = 0; i < X.shape()[0]; ++i) {
+            const double a = double((i / 2) % 2), b = double(i % 2);
+            X(i, 0) += a;
+            X(i, 1) += b;
+            Y(i, 0) = a != b ? 1.0 : 0.0;
+        }
+    }
+
+}
+
+int main() {
+    std::cout << "Testing training loop..." << std::endl;
+
+    // Metricas: separacion perfecta da AUC 1; un empate cuenta medio
+    MetricAccumulator<double> metrics;
+    Tensor<double, 2> scores(4, 1), labels(4, 1);
+    scores = {0.9, 0.2, 0.7, 0.4};
+    labels = {1, 0, 1, 0};
+    metrics.add_batch(scores, labels, 0.5);
+    assert(metrics.accuracy() == 1.0);
+    assert(std::fabs(metrics.auc() - 1.0) < 1e-12);
+    assert(std::fabs(metrics.loss() - 0.5) < 1e-12);
+    scores = {0.3, 0.3, 0.8, 0.1};
+    metrics.reset();
+    metrics.add_batch(scores, labels, 1.0);
+    assert(std::fabs(metrics.auc() - 0.875) < 1e-12);
+    assert(metrics.accuracy() == 0.75);
+
+    MetricAccumulator<double> multiclass;
+    Tensor<double, 2> probabilities(2, 3), classes(2, 1);
+    probabilities = {0.1, 0.7, 0.2, 0.5, 0.3, 0.2};
+    classes = {1, 2};
+    multiclass.add_batch(probabilities, classes, 0.0);
+    assert(multiclass.accuracy() == 0.5);
+    assert(std::isnan(multiclass.auc()));
+
+    // Contra one-hot: el argmax por fila no reserva memoria y ante empates gana el primero
+    Tensor<double, 2> one_hot(2, 3);
+    one_hot = {0, 1, 0, 0, 0, 1};
+    probabilities = {0.4, 0.4, 0.2, 0.1, 0.2, 0.7};
+    multiclass.reset();
+    const size_t allocations = utec_test::heap_allocations();
+    multiclass.add_batch(probabilities, one_hot, 0.0);
+    assert(utec_test::heap_allocations() == allocations);
+    assert(multiclass.accuracy() == 0.5);
+
+    Tensor<double, 2> X(256, 2), Y(256, 1), X_val(64, 2), Y_val(64, 1);
+    xor_data(X, Y);
+    xor_data(X_val, Y_val);
+
+    // La validacion asincrona ve la misma copia de pesos que la sincronica
+    NeuralNetwork<double> async_net, sync_net;
+    build(async_net);
+    build(sync_net);
+    Trainer<double, BCELoss, SGD> async_trainer(async_net), sync_trainer(sync_net);
+    std::ostringstream log;
+    async_trainer.emplace_callback<ProgressLogger<double>>(log, 10);
+    // El schedule no espera a la validacion asincrona: cambia el learning rate en la misma epoca
+    async_trainer.emplace_callback<StepDecay<double>>(10, 0.5);
+    sync_trainer.emplace_callback<StepDecay<double>>(10, 0.5);
+    async_trainer.validate_on(X_val, Y_val, true);
+    sync_trainer.validate_on(X_val, Y_val, false);
+    const auto& history = async_trainer.fit(X, Y, 30, 32, 0.5);
+    const auto& reference = sync_trainer.fit(X, Y, 30, 32, 0.5);
+    assert(history.size() == 30 && reference.size() == 30);
+    for (size_t e = 0; e < history.size(); ++e) {
+        assert(history[e].epoch == e && history[e].has_validation);
+        assert(history[e].learning_rate == reference[e].learning_rate);
+        assert(history[e].loss == reference[e].loss);
+        assert(history[e].val_loss == reference[e].val_loss);
+        assert(history[e].val_auc == reference[e].val_auc);
+    }
+    assert(history[9].learning_rate == 0.5 && history[10].learning_rate == 0.25);
+    assert(history.back().loss < history.front().loss);
+    assert(history.back().val_auc > 0.9);
+    assert(log.str().find("Epoca 30") != std::string::npos);
+
+    // Sin aprendizaje la perdida no mejora: se detiene tras `patience` epocas sin mejora
+    NeuralNetwork<double> frozen;
+    build(frozen);
+    Trainer<double, BCELoss, SGD> stopping(frozen);
+    auto& early = stopping.emplace_callback<EarlyStopping<double>>(3);
+    stopping.validate_on(X_val, Y_val, false);
+    assert(stopping.fit(X, Y, 50, 32, 0.0).size() == 4);
+    assert(early.stopped() && early.best_epoch() == 0);
+
+    // El schedule cambia el learning rate del optimizador para la epoca siguiente
+    NeuralNetwork<double> scheduled;
+    build(scheduled);
+    Trainer<double, BCELoss, SGD> decay(scheduled);
+    decay.emplace_callback<StepDecay<double>>(2, 0.5);
+    const auto& rates = decay.fit(X, Y, 5, 64, 0.4);
+    assert(rates[0].learning_rate == 0.4 && rates[1].learning_rate == 0.4);
+    assert(rates[2].learning_rate == 0.2 && rates[4].learning_rate == 0.1);
+    assert(!rates[0].has_validation);
+
+    std::cout << "All training tests passed!" << std::endl;
+    return 0;
+}